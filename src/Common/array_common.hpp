@@ -38,6 +38,31 @@ template <typename T> concept IndexType = SignedInteger<T> || SameAs<T, StrictIn
 namespace internal {
 
 
+// single character code of builtin type stored in binary formats
+template <Builtin T>
+STRICT_CONSTEXPR unsigned char type_code() {
+   if constexpr(SameAs<T, bool>) {
+      return 'b';
+   } else if constexpr(SameAs<T, int>) {
+      return 'i';
+   } else if constexpr(SameAs<T, long int>) {
+      return 'l';
+   } else if constexpr(SameAs<T, unsigned int>) {
+      return 'u';
+   } else if constexpr(SameAs<T, unsigned long int>) {
+      return 'U';
+   } else if constexpr(SameAs<T, float>) {
+      return 'f';
+   } else if constexpr(SameAs<T, double>) {
+      return 'd';
+   } else if constexpr(SameAs<T, long double>) {
+      return 'e';
+   } else {
+      return 'q';
+   }
+}
+
+
 template <typename T>
 class IndexWrapper {
 public:
@@ -275,10 +300,22 @@ STRICT_CONSTEXPR_INLINE void copy(List2D<T> L, Base& A) {
 }
 
 
+// expressions that are evaluated faster in parts, such as stencils, specialize this trait
+// and provide member copy_to(A2), which assigns all of their elements to A2
+template <typename T>
+struct CopiesItself {
+   static constexpr bool value = false;
+};
+
+
 template <BaseType Base1, BaseType Base2>
 STRICT_CONSTEXPR_INLINE void copy(const Base1& STRICT_RESTRICT A1, Base2& STRICT_RESTRICT A2) {
-   for(index_t i = 0_sl; i < A1.size(); ++i) {
-      A2.index(i) = A1.index(i);
+   if constexpr(CopiesItself<Base1>::value) {
+      A1.copy_to(A2);
+   } else {
+      for(index_t i = 0_sl; i < A1.size(); ++i) {
+         A2.index(i) = A1.index(i);
+      }
    }
 }
 
@@ -11,6 +11,7 @@
 #include "concepts.hpp"
 #include "config.hpp"
 #include "error.hpp"
+#include "parallel.hpp"
 #include "strict_IO.hpp"
 #include "strict_val.hpp"
 #include "strict_val_ops.hpp"
@@ -107,6 +107,7 @@ template <typename T> concept RealBaseType = BaseType<T> && Real<typename T::bui
 template <typename T> concept IntegerBaseType = BaseType<T> && Integer<typename T::builtin_type>;
 template <typename T> concept SignedIntegerBaseType = BaseType<T> && SignedInteger<typename T::builtin_type>;
 template <typename T> concept FloatingBaseType = BaseType<T> && Floating<typename T::builtin_type>;
+template <typename T> concept BooleanBaseType = BaseType<T> && Boolean<typename T::builtin_type>;
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -177,6 +178,7 @@ template <typename T> concept OneDimRealBaseType = OneDimBaseType<T> && RealBase
 template <typename T> concept OneDimIntegerBaseType = OneDimBaseType<T> && IntegerBaseType<T>;
 template <typename T> concept OneDimSignedIntegerBaseType = OneDimBaseType<T> && SignedIntegerBaseType<T>;
 template <typename T> concept OneDimFloatingBaseType = OneDimBaseType<T> && FloatingBaseType<T>;
+template <typename T> concept OneDimBooleanBaseType = OneDimBaseType<T> && BooleanBaseType<T>;
 template <typename T> concept OneDimNonConstBaseType = OneDimBaseType<T> && NonConstBaseType<T>;
 
 
@@ -186,6 +188,7 @@ template <typename T> concept TwoDimRealBaseType = TwoDimBaseType<T> && RealBase
 template <typename T> concept TwoDimIntegerBaseType = TwoDimBaseType<T> && IntegerBaseType<T>;
 template <typename T> concept TwoDimSignedIntegerBaseType = TwoDimBaseType<T> && SignedIntegerBaseType<T>;
 template <typename T> concept TwoDimFloatingBaseType = TwoDimBaseType<T> && FloatingBaseType<T>;
+template <typename T> concept TwoDimBooleanBaseType = TwoDimBaseType<T> && BooleanBaseType<T>;
 template <typename T> concept TwoDimNonConstBaseType = TwoDimBaseType<T> && NonConstBaseType<T>;
 
 
@@ -199,6 +202,11 @@ template <typename T1, typename T2, typename F> concept BinaryOperation
    && StrictType<decltype(std::declval<F>()(ValueTypeOf<T1>{}, ValueTypeOf<T2>{}))>;
 
 
+template <typename T1, typename T2, typename T3, typename F> concept TernaryOperation
+    = std::invocable<F, ValueTypeOf<T1>, ValueTypeOf<T2>, ValueTypeOf<T3>>
+   && StrictType<decltype(std::declval<F>()(ValueTypeOf<T1>{}, ValueTypeOf<T2>{}, ValueTypeOf<T3>{}))>;
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 struct StoreByCopy {};
 struct StoreByReference {};
@@ -93,6 +93,18 @@ static inline void config_info() {
 #else
    std::cout << "C++23 stacktrace: ON" << '\n';
 #endif
+
+#ifndef STRICT_EIGEN
+   std::cout << "Eigen interoperability: OFF" << '\n';
+#else
+   std::cout << "Eigen interoperability: ON" << '\n';
+#endif
+
+#ifndef _OPENMP
+   std::cout << "OpenMP parallelism: OFF" << '\n';
+#else
+   std::cout << "OpenMP parallelism: ON" << '\n';
+#endif
 }
 
 
@@ -0,0 +1,98 @@
+//  Copyright (C) 2024 Arkadijs Slobodkins - All Rights Reserved
+// License is 3-clause BSD:
+// https://github.com/arkslobodkins/strict-lib
+
+
+#pragma once
+
+
+#include <algorithm>  // min
+#include <atomic>     // atomic
+#include <exception>  // exception_ptr, current_exception, rethrow_exception
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "strict_val.hpp"
+
+
+// Thin layer over OpenMP. When compiled without OpenMP support all loops run serially.
+// Work is always split into a number of chunks that does not depend on the number of
+// threads, so that results of parallel algorithms are reproducible.
+namespace slib::internal {
+
+
+// number of elements below which parallel algorithms fall back to serial execution
+static constexpr inline long int parallel_threshold = 1L << 16;
+
+
+STRICT_INLINE int max_threads() {
+#ifdef _OPENMP
+   return omp_get_max_threads();
+#else
+   return 1;
+#endif
+}
+
+
+STRICT_INLINE int thread_id() {
+#ifdef _OPENMP
+   return omp_get_thread_num();
+#else
+   return 0;
+#endif
+}
+
+
+// calls f(c) for c = 0, ..., nchunks - 1 in parallel. Exceptions cannot leave a parallel region,
+// so that an exception thrown by f, e.g. by failed assertions when STRICT_ERROR_EXCEPTIONS is defined,
+// is stored, the remaining chunks are skipped, and the exception is rethrown after the region.
+// If several chunks throw, the exception of one of them is rethrown.
+template <typename F>
+void parallel_for(long int nchunks, F f) {
+   std::exception_ptr error;
+   std::atomic<bool> failed{false};
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if(nchunks > 1 && !omp_in_parallel())
+#endif
+   for(long int c = 0; c < nchunks; ++c) {
+      if(failed.load(std::memory_order_relaxed)) {
+         continue;
+      }
+      try {
+         f(c);
+      } catch(...) {
+#ifdef _OPENMP
+#pragma omp critical(slib_parallel_for)
+#endif
+         if(!error) {
+            error = std::current_exception();
+         }
+         failed.store(true, std::memory_order_relaxed);
+      }
+   }
+   if(error) {
+      std::rethrow_exception(error);
+   }
+}
+
+
+// number of chunks of size chunk needed to cover n elements
+STRICT_CONSTEXPR_INLINE long int chunk_count(long int n, long int chunk) {
+   return (n + chunk - 1) / chunk;
+}
+
+
+// calls f(first, last) in parallel for ranges [first, last) of size chunk that cover [0, n);
+// the last range is shorter if chunk does not divide n. Ranges start at multiples of chunk,
+// so that first / chunk is the index of the range.
+template <typename F>
+void parallel_for_range(long int n, long int chunk, F f) {
+   parallel_for(chunk_count(n, chunk), [n, chunk, &f](long int c) {
+      f(c * chunk, std::min(n, (c + 1) * chunk));
+   });
+}
+
+
+}  // namespace slib::internal
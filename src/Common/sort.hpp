@@ -0,0 +1,349 @@
+//  Copyright (C) 2024 Arkadijs Slobodkins - All Rights Reserved
+// License is 3-clause BSD:
+// https://github.com/arkslobodkins/strict-lib
+
+
+#pragma once
+
+
+#include <algorithm>    // copy, fill, merge, min, nth_element, sort
+#include <bit>          // bit_cast
+#include <cstdint>      // uint32_t, uint64_t
+#include <limits>       // numeric_limits
+#include <memory>       // unique_ptr, make_unique_for_overwrite
+#include <type_traits>  // conditional_t
+#include <vector>       // vector
+
+#include "concepts.hpp"
+#include "parallel.hpp"
+#include "strict_val.hpp"
+
+
+// Sorting of contiguous ranges of strict values.
+// Comparison sorts use std::sort on chunks in parallel, followed by rounds of pairwise merges,
+// each merge being split between tasks with the merge path partitioning.
+// Integer and floating point values of standard types are sorted by LSD radix sort on unsigned keys,
+// which preserve the order of values. Histograms are computed per chunk in parallel, and chunks
+// scatter their elements in parallel to precomputed offsets.
+namespace slib::internal {
+
+
+// number of elements processed by one task
+static constexpr inline long int sort_chunk = 1L << 16;
+
+
+// ranges below this size are sorted by std::sort
+static constexpr inline long int radix_threshold = 1L << 10;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// number of elements of a taken in the first k elements of the stable merge of a and b
+template <typename T, typename Compare>
+long int merge_corank(long int k, const T* a, long int na, const T* b, long int nb, Compare comp) {
+   long int lo = k > nb ? k - nb : 0;
+   long int hi = k < na ? k : na;
+   while(lo < hi) {
+      const long int i = lo + (hi - lo) / 2;
+      const long int j = k - i;
+      if(i < na && j > 0 && !comp(b[j - 1], a[i])) {
+         lo = i + 1;
+      } else {
+         hi = i;
+      }
+   }
+   return lo;
+}
+
+
+// stable merge of a and b into out
+template <typename T, typename Compare>
+void parallel_merge(const T* a, long int na, const T* b, long int nb, T* out, Compare comp) {
+   const long int n = na + nb;
+   parallel_for_range(n, sort_chunk, [=](long int k1, long int k2) {
+      const long int i1 = merge_corank(k1, a, na, b, nb, comp);
+      const long int i2 = merge_corank(k2, a, na, b, nb, comp);
+      std::merge(a + i1, a + i2, b + (k1 - i1), b + (k2 - i2), out + k1, comp);
+   });
+}
+
+
+template <typename T, typename Compare>
+void parallel_sort(T* x, long int n, Compare comp) {
+   if(n <= sort_chunk || max_threads() == 1) {
+      std::sort(x, x + n, comp);
+      return;
+   }
+
+   parallel_for_range(n, sort_chunk, [=](long int first, long int last) { std::sort(x + first, x + last, comp); });
+
+   auto buffer = std::make_unique_for_overwrite<T[]>(static_cast<std::size_t>(n));
+   T* from = x;
+   T* to = buffer.get();
+   for(long int width = sort_chunk; width < n; width *= 2) {
+      for(long int first = 0; first < n; first += 2 * width) {
+         const long int mid = std::min(n, first + width);
+         const long int last = std::min(n, first + 2 * width);
+         parallel_merge(from + first, mid - first, from + mid, last - mid, to + first, comp);
+      }
+      std::swap(from, to);
+   }
+   if(from != x) {
+      parallel_for_range(n, sort_chunk, [=](long int first, long int last) {
+         std::copy(from + first, from + last, x + first);
+      });
+   }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T> concept RadixSortable = Integer<T> || SameAs<T, float> || SameAs<T, double>;
+
+
+template <RadixSortable T>
+using RadixKey = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+
+
+// unsigned key whose order is the order of x; positive NaNs are placed after infinity
+template <RadixSortable T>
+STRICT_CONSTEXPR_INLINE RadixKey<T> radix_key(T x) {
+   using K = RadixKey<T>;
+   constexpr K sign = K{1} << (8 * sizeof(T) - 1);
+   const auto k = std::bit_cast<K>(x);
+   if constexpr(UnsignedInteger<T>) {
+      return k;
+   } else if constexpr(SignedInteger<T>) {
+      return k ^ sign;
+   } else {
+      return (k & sign) ? ~k : k | sign;
+   }
+}
+
+
+// inverse of radix_key
+template <RadixSortable T>
+STRICT_CONSTEXPR_INLINE T radix_value(RadixKey<T> k) {
+   using K = RadixKey<T>;
+   constexpr K sign = K{1} << (8 * sizeof(T) - 1);
+   if constexpr(UnsignedInteger<T>) {
+      return std::bit_cast<T>(k);
+   } else if constexpr(SignedInteger<T>) {
+      return std::bit_cast<T>(static_cast<K>(k ^ sign));
+   } else {
+      return std::bit_cast<T>(static_cast<K>((k & sign) ? k ^ sign : ~k));
+   }
+}
+
+
+// radix_key, where -0 is replaced by +0 and all NaNs by the positive quiet NaN, so that values that
+// compare equal have equal keys and NaNs are placed after infinity
+template <RadixSortable T>
+STRICT_CONSTEXPR_INLINE RadixKey<T> canonical_radix_key(T x) {
+   if constexpr(Floating<T>) {
+      if(x != x) {
+         return radix_key(std::numeric_limits<T>::quiet_NaN());
+      }
+      return radix_key(x == T(0) ? T(0) : x);
+   } else {
+      return radix_key(x);
+   }
+}
+
+
+// stable LSD radix sort with 8-bit digits of unsigned keys key(x[i])
+template <typename T, typename F>
+void radix_sort_by(T* x, long int n, F key) {
+   constexpr int nbytes = sizeof(key(x[0]));
+   const long int nchunks = chunk_count(n, sort_chunk);
+
+   auto buffer = std::make_unique_for_overwrite<T[]>(static_cast<std::size_t>(n));
+   T* from = x;
+   T* to = buffer.get();
+   std::vector<long int> count(static_cast<std::size_t>(nchunks * 256));
+
+   for(int d = 0; d < nbytes; ++d) {
+      const int shift = 8 * d;
+      parallel_for_range(n, sort_chunk, [&](long int first, long int last) {
+         const long int c = first / sort_chunk;
+         long int* h = count.data() + c * 256;
+         std::fill(h, h + 256, 0L);
+         for(long int i = first; i < last; ++i) {
+            ++h[(key(from[i]) >> shift) & 0xFF];
+         }
+      });
+
+      // digit d is the same for all elements
+      bool skip = false;
+      for(int b = 0; b < 256 && !skip; ++b) {
+         long int total = 0;
+         for(long int c = 0; c < nchunks; ++c) {
+            total += count[static_cast<std::size_t>(c * 256 + b)];
+         }
+         skip = total == n;
+      }
+      if(skip) {
+         continue;
+      }
+
+      // offsets in the order of digits, and chunks within each digit
+      long int offset = 0;
+      for(int b = 0; b < 256; ++b) {
+         for(long int c = 0; c < nchunks; ++c) {
+            auto& h = count[static_cast<std::size_t>(c * 256 + b)];
+            const long int t = h;
+            h = offset;
+            offset += t;
+         }
+      }
+
+      parallel_for_range(n, sort_chunk, [&](long int first, long int last) {
+         const long int c = first / sort_chunk;
+         long int* h = count.data() + c * 256;
+         for(long int i = first; i < last; ++i) {
+            to[h[(key(from[i]) >> shift) & 0xFF]++] = from[i];
+         }
+      });
+      std::swap(from, to);
+   }
+
+   if(from != x) {
+      std::copy(from, from + n, x);
+   }
+}
+
+
+// decreasing order is obtained by complementing keys
+template <RadixSortable T>
+void radix_sort(Strict<T>* x, long int n, bool decreasing) {
+   if(decreasing) {
+      radix_sort_by(x, n, [](Strict<T> v) { return static_cast<RadixKey<T>>(~radix_key(v.val())); });
+   } else {
+      radix_sort_by(x, n, [](Strict<T> v) { return radix_key(v.val()); });
+   }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// number of remaining candidates below which radix_select stores them and uses std::nth_element
+static constexpr inline long int select_threshold = 1L << 12;
+
+
+// k-th smallest(starting from 0) of values get(0), ..., get(n - 1) found by MSD radix selection:
+// every pass computes histograms of one digit of the keys that match the digits found so far.
+// Values are only read, so that get can evaluate expressions without storing them.
+template <RadixSortable T, typename F>
+T radix_select(long int n, long int k, F get) {
+   using K = RadixKey<T>;
+   constexpr int nbytes = sizeof(T);
+   const long int nchunks = chunk_count(n, sort_chunk);
+   std::vector<long int> count(static_cast<std::size_t>(nchunks * 256));
+
+   K prefix = 0;
+   K mask = 0;
+   long int remaining = n;
+   for(int d = nbytes - 1; d >= 0 && remaining > select_threshold; --d) {
+      const int shift = 8 * d;
+      parallel_for_range(n, sort_chunk, [&](long int first, long int last) {
+         const long int c = first / sort_chunk;
+         long int* h = count.data() + c * 256;
+         std::fill(h, h + 256, 0L);
+         for(long int i = first; i < last; ++i) {
+            if(const K key = radix_key(get(i)); (key & mask) == prefix) {
+               ++h[(key >> shift) & 0xFF];
+            }
+         }
+      });
+
+      for(K b = 0; b < 256; ++b) {
+         long int total = 0;
+         for(long int c = 0; c < nchunks; ++c) {
+            total += count[static_cast<std::size_t>(c * 256 + static_cast<long int>(b))];
+         }
+         if(k < total) {
+            prefix |= b << shift;
+            mask |= K{0xFF} << shift;
+            remaining = total;
+            break;
+         }
+         k -= total;
+      }
+   }
+
+   if(mask == ~K{0}) {
+      return radix_value<T>(prefix);
+   }
+
+   std::vector<std::vector<T>> parts(static_cast<std::size_t>(nchunks));
+   parallel_for_range(n, sort_chunk, [&](long int first, long int last) {
+      const long int c = first / sort_chunk;
+      for(long int i = first; i < last; ++i) {
+         if(const T x = get(i); (radix_key(x) & mask) == prefix) {
+            parts[static_cast<std::size_t>(c)].push_back(x);
+         }
+      }
+   });
+   std::vector<T> v;
+   v.reserve(static_cast<std::size_t>(remaining));
+   for(const auto& p : parts) {
+      v.insert(v.end(), p.begin(), p.end());
+   }
+   std::nth_element(v.begin(), v.begin() + k, v.end(),
+                    [](T a, T b) { return radix_key(a) < radix_key(b); });
+   return v[static_cast<std::size_t>(k)];
+}
+
+
+// rearranges x so that x[k] is its k-th smallest value, with smaller values before it and larger
+// values after it. The value is found by radix_select, and chunks count and scatter their elements
+// in parallel to offsets of the three classes, as in radix_sort_by.
+template <RadixSortable T>
+void radix_nth_element(Strict<T>* x, long int n, long int k) {
+   using K = RadixKey<T>;
+   const K pivot = radix_key(radix_select<T>(n, k, [x](long int i) { return x[i].val(); }));
+   const long int nchunks = chunk_count(n, sort_chunk);
+
+   // smaller and equal keys of every chunk, turned into offsets by prefix sums
+   std::vector<long int> nless(static_cast<std::size_t>(nchunks + 1));
+   std::vector<long int> nequal(static_cast<std::size_t>(nchunks + 1));
+   parallel_for_range(n, sort_chunk, [&](long int first, long int last) {
+      const long int c = first / sort_chunk;
+      long int l = 0, e = 0;
+      for(long int i = first; i < last; ++i) {
+         const K key = radix_key(x[i].val());
+         l += key < pivot;
+         e += key == pivot;
+      }
+      nless[static_cast<std::size_t>(c + 1)] = l;
+      nequal[static_cast<std::size_t>(c + 1)] = e;
+   });
+   for(std::size_t c = 1; c < nless.size(); ++c) {
+      nless[c] += nless[c - 1];
+      nequal[c] += nequal[c - 1];
+   }
+   const long int total_less = nless.back();
+   const long int total_equal = nequal.back();
+
+   auto buffer = std::make_unique_for_overwrite<Strict<T>[]>(static_cast<std::size_t>(n));
+   Strict<T>* to = buffer.get();
+   parallel_for_range(n, sort_chunk, [&](long int first, long int last) {
+      const long int c = first / sort_chunk;
+      long int pl = nless[static_cast<std::size_t>(c)];
+      long int pe = total_less + nequal[static_cast<std::size_t>(c)];
+      long int pg = total_less + total_equal + (first - pl - nequal[static_cast<std::size_t>(c)]);
+      for(long int i = first; i < last; ++i) {
+         const K key = radix_key(x[i].val());
+         if(key < pivot) {
+            to[pl++] = x[i];
+         } else if(key == pivot) {
+            to[pe++] = x[i];
+         } else {
+            to[pg++] = x[i];
+         }
+      }
+   });
+   parallel_for_range(n, sort_chunk, [&](long int first, long int last) {
+      std::copy(to + first, to + last, x + first);
+   });
+}
+
+
+}  // namespace slib::internal
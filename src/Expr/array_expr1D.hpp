@@ -6,7 +6,10 @@
 #pragma once
 
 
-#include <utility>
+#include <algorithm>  // max, minmax_element
+#include <array>      // array
+#include <limits>     // numeric_limits
+#include <utility>    // pair, declval
 
 #include "../derived1D.hpp"
 #include "exclude_last.hpp"
@@ -81,6 +84,52 @@ template <typename Base>
 STRICT_CONSTEXPR auto exclude(Base&& A, Pos p, Count n = Count{1}) = delete;
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Truncate keeps elements whose stencils lie inside of the array, Periodic wraps
+// stencils around the array, and ConstantPad reads pad outside of the array
+enum BoundaryFlag { Truncate, Periodic, ConstantPad };
+
+
+// element i is the sum of coeffs[k] * A[i + offsets[k]], e.g. stencil(A, {1._sd, -2._sd, 1._sd}, {-1, 0, 1});
+// for Truncate, element 0 is the first element whose stencil lies inside of A, so that element i
+// is centered at A[i + max(-min(offsets), 0)], and the result is empty if no stencil lies inside of A
+template <BoundaryFlag BF = Truncate, OneDimRealBaseType Base, std::size_t N>
+STRICT_CONSTEXPR auto stencil(const Base& A, const ValueTypeOf<Base> (&coeffs)[N], const ImplicitInt (&offsets)[N],
+                              ValueTypeOf<Base> pad = Zero<RealTypeOf<Base>>);
+
+
+// element i is A[i - k], so that elements move k positions to the right
+template <BoundaryFlag BF = ConstantPad, OneDimRealBaseType Base>
+   requires(BF != Truncate)
+STRICT_CONSTEXPR auto shift(const Base& A, ImplicitInt k, ValueTypeOf<Base> pad = Zero<RealTypeOf<Base>>);
+
+
+// differences of given order, e.g. diff<2>(A) is A[i + 2] - 2 * A[i + 1] + A[i];
+// the result has A.size() - order elements, or none if A.size() <= order
+template <long int order = 1, OneDimRealBaseType Base>
+   requires(order > 0)
+STRICT_CONSTEXPR auto diff(const Base& A);
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// deleted overloads
+template <BoundaryFlag BF = Truncate, typename Base, std::size_t N>
+   requires ArrayOneDimTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto stencil(Base&& A, const ValueTypeOf<Base> (&coeffs)[N], const ImplicitInt (&offsets)[N],
+                              ValueTypeOf<Base> pad = Zero<RealTypeOf<Base>>)
+    = delete;
+
+
+template <BoundaryFlag BF = ConstantPad, typename Base>
+   requires ArrayOneDimTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto shift(Base&& A, ImplicitInt k, ValueTypeOf<Base> pad = Zero<RealTypeOf<Base>>) = delete;
+
+
+template <long int order = 1, typename Base>
+   requires ArrayOneDimTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto diff(Base&& A) = delete;
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <Real T>
 STRICT_CONSTEXPR auto sequence(ImplicitInt size, Strict<T> start = Strict<T>{},
@@ -215,6 +264,22 @@ template <Builtin T, OneDimBaseType Base>
 STRICT_CONSTEXPR auto array_cast(const Base& A);
 
 
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto clamp(const Base& A, ValueTypeOf<Base> low, ValueTypeOf<Base> high);
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto clamp(const Base& A, Low<RealTypeOf<Base>> low, High<RealTypeOf<Base>> high);
+
+
+// NaN, positive infinity, and negative infinity are replaced by nan, posinf, and neginf
+template <OneDimFloatingBaseType Base>
+   requires StandardFloating<RealTypeOf<Base>>
+STRICT_CONSTEXPR auto nan_to_num(const Base& A, ValueTypeOf<Base> nan = Zero<RealTypeOf<Base>>,
+                                 ValueTypeOf<Base> posinf = Strict{std::numeric_limits<RealTypeOf<Base>>::max()},
+                                 ValueTypeOf<Base> neginf = Strict{std::numeric_limits<RealTypeOf<Base>>::lowest()});
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // deleted overloads
 template <typename Base>
@@ -307,6 +372,24 @@ template <Builtin T, typename Base>
 STRICT_CONSTEXPR auto array_cast(Base&& A) = delete;
 
 
+template <typename Base>
+   requires ArrayOneDimRealTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto clamp(Base&& A, ValueTypeOf<Base> low, ValueTypeOf<Base> high) = delete;
+
+
+template <typename Base>
+   requires ArrayOneDimRealTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto clamp(Base&& A, Low<RealTypeOf<Base>> low, High<RealTypeOf<Base>> high) = delete;
+
+
+template <typename Base>
+   requires ArrayOneDimFloatTypeRvalueWith<Base> && StandardFloating<RealTypeOf<Base>>
+STRICT_CONSTEXPR auto nan_to_num(Base&& A, ValueTypeOf<Base> nan = Zero<RealTypeOf<Base>>,
+                                 ValueTypeOf<Base> posinf = Strict{std::numeric_limits<RealTypeOf<Base>>::max()},
+                                 ValueTypeOf<Base> neginf = Strict{std::numeric_limits<RealTypeOf<Base>>::lowest()})
+    = delete;
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // binary operations
 template <OneDimBaseType Base1, OneDimBaseType Base2, typename F, bool copy_delete = false>
@@ -314,6 +397,11 @@ template <OneDimBaseType Base1, OneDimBaseType Base2, typename F, bool copy_dele
 STRICT_CONSTEXPR auto generate1D(const Base1& A1, const Base2& A2, F f);
 
 
+template <OneDimBaseType Base1, OneDimBaseType Base2, OneDimBaseType Base3, typename F, bool copy_delete = false>
+   requires TernaryOperation<Base1, Base2, Base3, F>
+STRICT_CONSTEXPR auto generate1D(const Base1& A1, const Base2& A2, const Base3& A3, F f);
+
+
 template <OneDimRealBaseType Base1, OneDimRealBaseType Base2>
 STRICT_CONSTEXPR auto operator+(const Base1& A1, const Base2& A2);
 
@@ -612,6 +700,255 @@ template <typename Base>
 STRICT_CONSTEXPR auto operator^(Base&& A, ValueTypeOf<Base> x) = delete;
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// elementwise comparisons and logical operations, which return expressions of StrictBool.
+// operator== and operator!= of two arrays compare arrays as a whole, so that
+// elementwise equality of two arrays is provided by equal and not_equal
+template <OneDimBaseType Base1, OneDimBaseType Base2>
+STRICT_CONSTEXPR auto equal(const Base1& A1, const Base2& A2);
+
+
+template <OneDimBaseType Base1, OneDimBaseType Base2>
+STRICT_CONSTEXPR auto not_equal(const Base1& A1, const Base2& A2);
+
+
+template <OneDimRealBaseType Base1, OneDimRealBaseType Base2>
+STRICT_CONSTEXPR auto operator<(const Base1& A1, const Base2& A2);
+
+
+template <OneDimRealBaseType Base1, OneDimRealBaseType Base2>
+STRICT_CONSTEXPR auto operator<=(const Base1& A1, const Base2& A2);
+
+
+template <OneDimRealBaseType Base1, OneDimRealBaseType Base2>
+STRICT_CONSTEXPR auto operator>(const Base1& A1, const Base2& A2);
+
+
+template <OneDimRealBaseType Base1, OneDimRealBaseType Base2>
+STRICT_CONSTEXPR auto operator>=(const Base1& A1, const Base2& A2);
+
+
+template <OneDimBooleanBaseType Base1, OneDimBooleanBaseType Base2>
+STRICT_CONSTEXPR auto operator&&(const Base1& A1, const Base2& A2);
+
+
+template <OneDimBooleanBaseType Base1, OneDimBooleanBaseType Base2>
+STRICT_CONSTEXPR auto operator||(const Base1& A1, const Base2& A2);
+
+
+template <OneDimBooleanBaseType Base>
+STRICT_CONSTEXPR auto operator!(const Base& A);
+
+
+template <OneDimBaseType Base>
+STRICT_CONSTEXPR auto operator==(const Base& A, ValueTypeOf<Base> x);
+
+
+template <OneDimBaseType Base>
+STRICT_CONSTEXPR auto operator!=(const Base& A, ValueTypeOf<Base> x);
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator<(const Base& A, ValueTypeOf<Base> x);
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator<=(const Base& A, ValueTypeOf<Base> x);
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator>(const Base& A, ValueTypeOf<Base> x);
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator>=(const Base& A, ValueTypeOf<Base> x);
+
+
+template <OneDimBaseType Base>
+STRICT_CONSTEXPR auto operator==(ValueTypeOf<Base> x, const Base& A);
+
+
+template <OneDimBaseType Base>
+STRICT_CONSTEXPR auto operator!=(ValueTypeOf<Base> x, const Base& A);
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator<(ValueTypeOf<Base> x, const Base& A);
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator<=(ValueTypeOf<Base> x, const Base& A);
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator>(ValueTypeOf<Base> x, const Base& A);
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator>=(ValueTypeOf<Base> x, const Base& A);
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// deleted overloads
+template <typename Base1, typename Base2>
+   requires(OneDimBaseType<RemoveRef<Base1>> && OneDimBaseType<RemoveRef<Base2>>)
+            && (ArrayOneDimTypeRvalueWith<Base1> || ArrayOneDimTypeRvalueWith<Base2>)
+STRICT_CONSTEXPR auto equal(Base1&& A1, Base2&& A2) = delete;
+
+
+template <typename Base1, typename Base2>
+   requires(OneDimBaseType<RemoveRef<Base1>> && OneDimBaseType<RemoveRef<Base2>>)
+            && (ArrayOneDimTypeRvalueWith<Base1> || ArrayOneDimTypeRvalueWith<Base2>)
+STRICT_CONSTEXPR auto not_equal(Base1&& A1, Base2&& A2) = delete;
+
+
+template <typename Base1, typename Base2>
+   requires(OneDimRealBaseType<RemoveRef<Base1>> && OneDimRealBaseType<RemoveRef<Base2>>)
+            && (ArrayOneDimRealTypeRvalueWith<Base1> || ArrayOneDimRealTypeRvalueWith<Base2>)
+STRICT_CONSTEXPR auto operator<(Base1&& A1, Base2&& A2) = delete;
+
+
+template <typename Base1, typename Base2>
+   requires(OneDimRealBaseType<RemoveRef<Base1>> && OneDimRealBaseType<RemoveRef<Base2>>)
+            && (ArrayOneDimRealTypeRvalueWith<Base1> || ArrayOneDimRealTypeRvalueWith<Base2>)
+STRICT_CONSTEXPR auto operator<=(Base1&& A1, Base2&& A2) = delete;
+
+
+template <typename Base1, typename Base2>
+   requires(OneDimRealBaseType<RemoveRef<Base1>> && OneDimRealBaseType<RemoveRef<Base2>>)
+            && (ArrayOneDimRealTypeRvalueWith<Base1> || ArrayOneDimRealTypeRvalueWith<Base2>)
+STRICT_CONSTEXPR auto operator>(Base1&& A1, Base2&& A2) = delete;
+
+
+template <typename Base1, typename Base2>
+   requires(OneDimRealBaseType<RemoveRef<Base1>> && OneDimRealBaseType<RemoveRef<Base2>>)
+            && (ArrayOneDimRealTypeRvalueWith<Base1> || ArrayOneDimRealTypeRvalueWith<Base2>)
+STRICT_CONSTEXPR auto operator>=(Base1&& A1, Base2&& A2) = delete;
+
+
+template <typename Base1, typename Base2>
+   requires(OneDimBooleanBaseType<RemoveRef<Base1>> && OneDimBooleanBaseType<RemoveRef<Base2>>)
+            && (ArrayOneDimBooleanTypeRvalueWith<Base1> || ArrayOneDimBooleanTypeRvalueWith<Base2>)
+STRICT_CONSTEXPR auto operator&&(Base1&& A1, Base2&& A2) = delete;
+
+
+template <typename Base1, typename Base2>
+   requires(OneDimBooleanBaseType<RemoveRef<Base1>> && OneDimBooleanBaseType<RemoveRef<Base2>>)
+            && (ArrayOneDimBooleanTypeRvalueWith<Base1> || ArrayOneDimBooleanTypeRvalueWith<Base2>)
+STRICT_CONSTEXPR auto operator||(Base1&& A1, Base2&& A2) = delete;
+
+
+template <typename Base>
+   requires ArrayOneDimBooleanTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto operator!(Base&& A) = delete;
+
+
+template <typename Base>
+   requires ArrayOneDimTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto operator==(Base&& A, ValueTypeOf<Base> x) = delete;
+
+
+template <typename Base>
+   requires ArrayOneDimTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto operator!=(Base&& A, ValueTypeOf<Base> x) = delete;
+
+
+template <typename Base>
+   requires ArrayOneDimRealTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto operator<(Base&& A, ValueTypeOf<Base> x) = delete;
+
+
+template <typename Base>
+   requires ArrayOneDimRealTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto operator<=(Base&& A, ValueTypeOf<Base> x) = delete;
+
+
+template <typename Base>
+   requires ArrayOneDimRealTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto operator>(Base&& A, ValueTypeOf<Base> x) = delete;
+
+
+template <typename Base>
+   requires ArrayOneDimRealTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto operator>=(Base&& A, ValueTypeOf<Base> x) = delete;
+
+
+template <typename Base>
+   requires ArrayOneDimTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto operator==(ValueTypeOf<Base> x, Base&& A) = delete;
+
+
+template <typename Base>
+   requires ArrayOneDimTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto operator!=(ValueTypeOf<Base> x, Base&& A) = delete;
+
+
+template <typename Base>
+   requires ArrayOneDimRealTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto operator<(ValueTypeOf<Base> x, Base&& A) = delete;
+
+
+template <typename Base>
+   requires ArrayOneDimRealTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto operator<=(ValueTypeOf<Base> x, Base&& A) = delete;
+
+
+template <typename Base>
+   requires ArrayOneDimRealTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto operator>(ValueTypeOf<Base> x, Base&& A) = delete;
+
+
+template <typename Base>
+   requires ArrayOneDimRealTypeRvalueWith<Base>
+STRICT_CONSTEXPR auto operator>=(ValueTypeOf<Base> x, Base&& A) = delete;
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// elementwise selection M ? A1 : A2; scalars are allowed in place of arrays
+// and are not converted to expressions
+template <OneDimBooleanBaseType BaseM, OneDimBaseType Base1, OneDimBaseType Base2>
+STRICT_CONSTEXPR auto where(const BaseM& M, const Base1& A1, const Base2& A2);
+
+
+template <OneDimBooleanBaseType BaseM, OneDimBaseType Base>
+STRICT_CONSTEXPR auto where(const BaseM& M, const Base& A, ValueTypeOf<Base> y);
+
+
+template <OneDimBooleanBaseType BaseM, OneDimBaseType Base>
+STRICT_CONSTEXPR auto where(const BaseM& M, ValueTypeOf<Base> x, const Base& A);
+
+
+template <OneDimBooleanBaseType BaseM, Builtin T>
+STRICT_CONSTEXPR auto where(const BaseM& M, Strict<T> x, Strict<T> y);
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// deleted overloads
+template <typename BaseM, typename Base1, typename Base2>
+   requires(OneDimBooleanBaseType<RemoveRef<BaseM>> && OneDimBaseType<RemoveRef<Base1>>
+            && OneDimBaseType<RemoveRef<Base2>>)
+            && (ArrayOneDimTypeRvalueWith<BaseM> || ArrayOneDimTypeRvalueWith<Base1>
+                || ArrayOneDimTypeRvalueWith<Base2>)
+STRICT_CONSTEXPR auto where(BaseM&& M, Base1&& A1, Base2&& A2) = delete;
+
+
+template <typename BaseM, typename Base>
+   requires(OneDimBooleanBaseType<RemoveRef<BaseM>> && OneDimBaseType<RemoveRef<Base>>)
+            && (ArrayOneDimTypeRvalueWith<BaseM> || ArrayOneDimTypeRvalueWith<Base>)
+STRICT_CONSTEXPR auto where(BaseM&& M, Base&& A, ValueTypeOf<Base> y) = delete;
+
+
+template <typename BaseM, typename Base>
+   requires(OneDimBooleanBaseType<RemoveRef<BaseM>> && OneDimBaseType<RemoveRef<Base>>)
+            && (ArrayOneDimTypeRvalueWith<BaseM> || ArrayOneDimTypeRvalueWith<Base>)
+STRICT_CONSTEXPR auto where(BaseM&& M, ValueTypeOf<Base> x, Base&& A) = delete;
+
+
+template <typename BaseM, Builtin T>
+   requires ArrayOneDimBooleanTypeRvalueWith<BaseM>
+STRICT_CONSTEXPR auto where(BaseM&& M, Strict<T> x, Strict<T> y) = delete;
+
+
 namespace internal {
 // workaround before CWG2518/P2593R1
 template <typename>
@@ -699,6 +1036,54 @@ private:
 };
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <OneDimBaseType Base1, OneDimBaseType Base2, OneDimBaseType Base3, typename Op, bool copy_delete = false>
+   requires TernaryOperation<Base1, Base2, Base3, Op>
+class STRICT_NODISCARD TernaryExpr1D : private CopyBase1D {
+public:
+   using value_type
+       = decltype(std::declval<Op>()(ValueTypeOf<Base1>{}, ValueTypeOf<Base2>{}, ValueTypeOf<Base3>{}));
+   using builtin_type = value_type::value_type;
+
+   STRICT_NODISCARD_CONSTEXPR explicit TernaryExpr1D(const Base1& A1, const Base2& A2, const Base3& A3, Op op)
+       : A1_{A1},
+         A2_{A2},
+         A3_{A3},
+         op_{op} {
+      ASSERT_STRICT_DEBUG(same_size(A1_, A2_, A3_));
+   }
+
+   STRICT_NODISCARD_CONSTEXPR TernaryExpr1D(const TernaryExpr1D& E)
+       : A1_{E.A1_},
+         A2_{E.A2_},
+         A3_{E.A3_},
+         op_{E.op_} {
+      if constexpr(copy_delete) {
+         static_assert(internal::static_false<decltype(*this)>,
+                       "Copying this expression template is not allowed for additional safety");
+      }
+   }
+
+   STRICT_CONSTEXPR TernaryExpr1D& operator=(const TernaryExpr1D&) = delete;
+   STRICT_CONSTEXPR ~TernaryExpr1D() = default;
+
+   STRICT_NODISCARD_CONSTEXPR_INLINE value_type index(ImplicitInt i) const {
+      return op_(A1_.index(i), A2_.index(i), A3_.index(i));
+   }
+
+   STRICT_NODISCARD_CONSTEXPR_INLINE index_t size() const {
+      return A1_.size();
+   }
+
+private:
+   // slice arrays are stored by copy, arrays by reference
+   typename CopyOrReferenceExpr<AddConst<Base1>>::type A1_;
+   typename CopyOrReferenceExpr<AddConst<Base2>>::type A2_;
+   typename CopyOrReferenceExpr<AddConst<Base3>>::type A3_;
+   Op op_;
+};
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <Real T>
 class STRICT_NODISCARD SequenceExpr1D : private CopyBase1D {
@@ -733,6 +1118,137 @@ private:
 };
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// All taps read the same expression at fixed distances, so that for contiguous arrays they are
+// unaligned loads from one pointer, which vectorize and share registers across iterations. The
+// number of taps is known at compile time, so that the sum of taps is unrolled. Elements near
+// boundaries select wrapped or padded taps without branches.
+template <OneDimRealBaseType Base, std::size_t N, BoundaryFlag BF>
+class STRICT_NODISCARD StencilExpr1D : private CopyBase1D {
+public:
+   using value_type = ValueTypeOf<Base>;
+   using builtin_type = BuiltinTypeOf<Base>;
+
+   STRICT_NODISCARD_CONSTEXPR explicit StencilExpr1D(const Base& A, const std::array<value_type, N>& coeffs,
+                                                     const std::array<long int, N>& offsets, value_type pad)
+       : A_{A},
+         coeffs_{coeffs},
+         offsets_{offsets},
+         pad_{pad},
+         n_{A.size().val()},
+         size_{A.size()} {
+      static_assert(N > 0);
+      const auto [min_off, max_off] = std::minmax_element(offsets_.begin(), offsets_.end());
+      long int lo = *min_off;
+      long int hi = *max_off;
+      if constexpr(BF == Truncate) {
+         // offsets are taken relative to the first element whose stencil lies inside of A, which is
+         // the element -lo if some offset is negative, and 0 otherwise
+         const long int first = std::max(-lo, 0L);
+         for(auto& off : offsets_) {
+            off += first;
+         }
+         size_ = index_t{std::max(n_ - std::max(hi, 0L) - first, 0L)};
+         lo += first;
+         hi += first;
+      } else if constexpr(BF == Periodic) {
+         ASSERT_STRICT_DEBUG(n_ == 0 || (lo >= -n_ && hi <= n_));
+      }
+      // elements first_, ..., last_ - 1 do not need boundary conditions
+      first_ = std::min(std::max(-lo, 0L), size_.val());
+      last_ = std::max(std::min(n_ - hi, size_.val()), first_);
+   }
+
+   STRICT_NODISCARD_CONSTEXPR StencilExpr1D(const StencilExpr1D&) = default;
+   STRICT_CONSTEXPR StencilExpr1D& operator=(const StencilExpr1D&) = delete;
+   STRICT_CONSTEXPR ~StencilExpr1D() = default;
+
+   STRICT_NODISCARD_CONSTEXPR_INLINE value_type index(ImplicitInt i) const {
+      const long int iv = i.get().val();
+      if constexpr(BF != Truncate) {
+         if(iv >= first_ && iv < last_) {
+            return this->interior(iv);
+         }
+      }
+      return this->boundary(iv);
+   }
+
+   STRICT_NODISCARD_CONSTEXPR_INLINE index_t size() const {
+      return size_;
+   }
+
+   // called when the expression is assigned; elements near boundaries are evaluated
+   // separately, so that the loop over the interior vectorizes
+   template <typename Out>
+   STRICT_CONSTEXPR void copy_to(Out& R) const {
+      for(long int i = 0; i < first_; ++i) {
+         R.index(i) = this->boundary(i);
+      }
+      for(long int i = first_; i < last_; ++i) {
+         R.index(i) = this->interior(i);
+      }
+      for(long int i = last_; i < size_.val(); ++i) {
+         R.index(i) = this->boundary(i);
+      }
+   }
+
+private:
+   // slice arrays are stored by copy, arrays by reference
+   typename CopyOrReferenceExpr<AddConst<Base>>::type A_;
+   std::array<value_type, N> coeffs_;
+   std::array<long int, N> offsets_;
+   value_type pad_;
+   long int n_;
+   index_t size_;
+   long int first_;
+   long int last_;
+
+   template <typename F>
+   STRICT_CONSTEXPR_INLINE value_type combine(long int i, F f) const {
+      value_type r = coeffs_[0] * f(i + offsets_[0]);
+      for(std::size_t k = 1; k < N; ++k) {
+         r += coeffs_[k] * f(i + offsets_[k]);
+      }
+      return r;
+   }
+
+   STRICT_CONSTEXPR_INLINE value_type interior(long int i) const {
+      return this->combine(i, [this](long int j) { return A_.index(j); });
+   }
+
+   STRICT_CONSTEXPR_INLINE value_type boundary(long int i) const {
+      return this->combine(i, [this](long int j) { return this->tap(j); });
+   }
+
+   STRICT_CONSTEXPR_INLINE value_type tap(long int j) const {
+      if constexpr(BF == Truncate) {
+         return A_.index(j);
+      } else if constexpr(BF == Periodic) {
+         j += j < 0 ? n_ : 0;
+         j -= j >= n_ ? n_ : 0;
+         return A_.index(j);
+      } else {
+         // out of range elements are read from position 0 and replaced by pad
+         const bool in = static_cast<unsigned long int>(j) < static_cast<unsigned long int>(n_);
+         const value_type x = A_.index(in ? j : 0);
+         return in ? x : pad_;
+      }
+   }
+};
+
+
+namespace internal {
+
+
+template <OneDimRealBaseType Base, std::size_t N, BoundaryFlag BF>
+struct CopiesItself<Derived1D<StencilExpr1D<Base, N, BF>>> {
+   static constexpr bool value = true;
+};
+
+
+}  // namespace internal
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <OneDimBaseType Base, typename F, bool copy_delete>
    requires UnaryOperation<Base, F>
@@ -849,6 +1365,27 @@ STRICT_CONSTEXPR auto array_cast(const Base& A) {
 }
 
 
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto clamp(const Base& A, ValueTypeOf<Base> low, ValueTypeOf<Base> high) {
+   ASSERT_STRICT_DEBUG(low <= high);
+   return generate1D(A, UnaryClamp<RealTypeOf<Base>>{low, high});
+}
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto clamp(const Base& A, Low<RealTypeOf<Base>> low, High<RealTypeOf<Base>> high) {
+   return clamp(A, low.get(), high.get());
+}
+
+
+template <OneDimFloatingBaseType Base>
+   requires StandardFloating<RealTypeOf<Base>>
+STRICT_CONSTEXPR auto nan_to_num(const Base& A, ValueTypeOf<Base> nan, ValueTypeOf<Base> posinf,
+                                 ValueTypeOf<Base> neginf) {
+   return generate1D(A, UnaryNanToNum<RealTypeOf<Base>>{nan, posinf, neginf});
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <OneDimBaseType Base1, OneDimBaseType Base2, typename F, bool copy_delete>
    requires BinaryOperation<Base1, Base2, F>
@@ -857,6 +1394,13 @@ STRICT_CONSTEXPR auto generate1D(const Base1& A1, const Base2& A2, F f) {
 }
 
 
+template <OneDimBaseType Base1, OneDimBaseType Base2, OneDimBaseType Base3, typename F, bool copy_delete>
+   requires TernaryOperation<Base1, Base2, Base3, F>
+STRICT_CONSTEXPR auto generate1D(const Base1& A1, const Base2& A2, const Base3& A3, F f) {
+   return Derived1D<TernaryExpr1D<Base1, Base2, Base3, F, copy_delete>>(A1, A2, A3, f);
+}
+
+
 template <OneDimRealBaseType Base1, OneDimRealBaseType Base2>
 STRICT_CONSTEXPR auto operator+(const Base1& A1, const Base2& A2) {
    return generate1D(A1, A2, BinaryPlus{});
@@ -1045,6 +1589,158 @@ STRICT_CONSTEXPR auto operator^(const Base& A, ValueTypeOf<Base> x) {
 }
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <OneDimBaseType Base1, OneDimBaseType Base2>
+STRICT_CONSTEXPR auto equal(const Base1& A1, const Base2& A2) {
+   return generate1D(A1, A2, BinaryEqual{});
+}
+
+
+template <OneDimBaseType Base1, OneDimBaseType Base2>
+STRICT_CONSTEXPR auto not_equal(const Base1& A1, const Base2& A2) {
+   return generate1D(A1, A2, BinaryNotEqual{});
+}
+
+
+template <OneDimRealBaseType Base1, OneDimRealBaseType Base2>
+STRICT_CONSTEXPR auto operator<(const Base1& A1, const Base2& A2) {
+   return generate1D(A1, A2, BinaryLess{});
+}
+
+
+template <OneDimRealBaseType Base1, OneDimRealBaseType Base2>
+STRICT_CONSTEXPR auto operator<=(const Base1& A1, const Base2& A2) {
+   return generate1D(A1, A2, BinaryLessEqual{});
+}
+
+
+template <OneDimRealBaseType Base1, OneDimRealBaseType Base2>
+STRICT_CONSTEXPR auto operator>(const Base1& A1, const Base2& A2) {
+   return generate1D(A1, A2, BinaryGreater{});
+}
+
+
+template <OneDimRealBaseType Base1, OneDimRealBaseType Base2>
+STRICT_CONSTEXPR auto operator>=(const Base1& A1, const Base2& A2) {
+   return generate1D(A1, A2, BinaryGreaterEqual{});
+}
+
+
+template <OneDimBooleanBaseType Base1, OneDimBooleanBaseType Base2>
+STRICT_CONSTEXPR auto operator&&(const Base1& A1, const Base2& A2) {
+   return generate1D(A1, A2, BinaryLogicalAnd{});
+}
+
+
+template <OneDimBooleanBaseType Base1, OneDimBooleanBaseType Base2>
+STRICT_CONSTEXPR auto operator||(const Base1& A1, const Base2& A2) {
+   return generate1D(A1, A2, BinaryLogicalOr{});
+}
+
+
+template <OneDimBooleanBaseType Base>
+STRICT_CONSTEXPR auto operator!(const Base& A) {
+   return generate1D(A, UnaryNot{});
+}
+
+
+template <OneDimBaseType Base>
+STRICT_CONSTEXPR auto operator==(const Base& A, ValueTypeOf<Base> x) {
+   return generate1D(A, const1D<BuiltinTypeOf<Base>>(A.size(), x), BinaryEqual{});
+}
+
+
+template <OneDimBaseType Base>
+STRICT_CONSTEXPR auto operator!=(const Base& A, ValueTypeOf<Base> x) {
+   return generate1D(A, const1D<BuiltinTypeOf<Base>>(A.size(), x), BinaryNotEqual{});
+}
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator<(const Base& A, ValueTypeOf<Base> x) {
+   return generate1D(A, const1D<BuiltinTypeOf<Base>>(A.size(), x), BinaryLess{});
+}
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator<=(const Base& A, ValueTypeOf<Base> x) {
+   return generate1D(A, const1D<BuiltinTypeOf<Base>>(A.size(), x), BinaryLessEqual{});
+}
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator>(const Base& A, ValueTypeOf<Base> x) {
+   return generate1D(A, const1D<BuiltinTypeOf<Base>>(A.size(), x), BinaryGreater{});
+}
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator>=(const Base& A, ValueTypeOf<Base> x) {
+   return generate1D(A, const1D<BuiltinTypeOf<Base>>(A.size(), x), BinaryGreaterEqual{});
+}
+
+
+template <OneDimBaseType Base>
+STRICT_CONSTEXPR auto operator==(ValueTypeOf<Base> x, const Base& A) {
+   return generate1D(const1D<BuiltinTypeOf<Base>>(A.size(), x), A, BinaryEqual{});
+}
+
+
+template <OneDimBaseType Base>
+STRICT_CONSTEXPR auto operator!=(ValueTypeOf<Base> x, const Base& A) {
+   return generate1D(const1D<BuiltinTypeOf<Base>>(A.size(), x), A, BinaryNotEqual{});
+}
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator<(ValueTypeOf<Base> x, const Base& A) {
+   return generate1D(const1D<BuiltinTypeOf<Base>>(A.size(), x), A, BinaryLess{});
+}
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator<=(ValueTypeOf<Base> x, const Base& A) {
+   return generate1D(const1D<BuiltinTypeOf<Base>>(A.size(), x), A, BinaryLessEqual{});
+}
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator>(ValueTypeOf<Base> x, const Base& A) {
+   return generate1D(const1D<BuiltinTypeOf<Base>>(A.size(), x), A, BinaryGreater{});
+}
+
+
+template <OneDimRealBaseType Base>
+STRICT_CONSTEXPR auto operator>=(ValueTypeOf<Base> x, const Base& A) {
+   return generate1D(const1D<BuiltinTypeOf<Base>>(A.size(), x), A, BinaryGreaterEqual{});
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <OneDimBooleanBaseType BaseM, OneDimBaseType Base1, OneDimBaseType Base2>
+STRICT_CONSTEXPR auto where(const BaseM& M, const Base1& A1, const Base2& A2) {
+   return generate1D(M, A1, A2, TernarySelect{});
+}
+
+
+template <OneDimBooleanBaseType BaseM, OneDimBaseType Base>
+STRICT_CONSTEXPR auto where(const BaseM& M, const Base& A, ValueTypeOf<Base> y) {
+   return generate1D(M, A, BinarySelectFirst<BuiltinTypeOf<Base>>{y});
+}
+
+
+template <OneDimBooleanBaseType BaseM, OneDimBaseType Base>
+STRICT_CONSTEXPR auto where(const BaseM& M, ValueTypeOf<Base> x, const Base& A) {
+   return generate1D(M, A, BinarySelectSecond<BuiltinTypeOf<Base>>{x});
+}
+
+
+template <OneDimBooleanBaseType BaseM, Builtin T>
+STRICT_CONSTEXPR auto where(const BaseM& M, Strict<T> x, Strict<T> y) {
+   return generate1D(M, UnarySelect<T>{x, y});
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <OneDimBaseType Base, OneDimBaseType... BArgs>
 STRICT_CONSTEXPR auto merge(const Base& A, const BArgs&... AArgs) {
@@ -1111,6 +1807,51 @@ STRICT_CONSTEXPR auto exclude(const Base& A, Pos p, Count n) {
 }
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <BoundaryFlag BF, OneDimRealBaseType Base, std::size_t N>
+STRICT_CONSTEXPR auto stencil(const Base& A, const ValueTypeOf<Base> (&coeffs)[N], const ImplicitInt (&offsets)[N],
+                              ValueTypeOf<Base> pad) {
+   std::array<ValueTypeOf<Base>, N> c;
+   std::array<long int, N> off;
+   for(std::size_t k = 0; k < N; ++k) {
+      c[k] = coeffs[k];
+      off[k] = offsets[k].get().val();
+   }
+   return Derived1D<StencilExpr1D<Base, N, BF>>{A, c, off, pad};
+}
+
+
+template <BoundaryFlag BF, OneDimRealBaseType Base>
+   requires(BF != Truncate)
+STRICT_CONSTEXPR auto shift(const Base& A, ImplicitInt k, ValueTypeOf<Base> pad) {
+   return stencil<BF>(A, {One<RealTypeOf<Base>>}, {-k.get()}, pad);
+}
+
+
+template <long int order, OneDimRealBaseType Base>
+   requires(order > 0)
+STRICT_CONSTEXPR auto diff(const Base& A) {
+   constexpr auto N = static_cast<std::size_t>(order + 1);
+   // binomial coefficients with alternating signs
+   std::array<long int, N> binom{};
+   binom[0] = 1;
+   for(std::size_t k = 1; k < N; ++k) {
+      for(std::size_t j = k; j > 0; --j) {
+         binom[j] += binom[j - 1];
+      }
+   }
+
+   std::array<ValueTypeOf<Base>, N> c;
+   std::array<long int, N> off;
+   for(std::size_t k = 0; k < N; ++k) {
+      const long int b = (N - 1 - k) % 2 == 0 ? binom[k] : -binom[k];
+      c[k] = value_type_cast<Base>(index_t{b});
+      off[k] = static_cast<long int>(k);
+   }
+   return Derived1D<StencilExpr1D<Base, N, Truncate>>{A, c, off, Zero<RealTypeOf<Base>>};
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <Real T>
 STRICT_CONSTEXPR auto sequence(ImplicitInt size, Strict<T> start, Strict<T> incr) {
@@ -6,8 +6,11 @@
 #pragma once
 
 
+#include <limits>  // numeric_limits
+
 #include "../Common/auxiliary_types.hpp"
 #include "../Common/strict_val.hpp"
+#include "../Common/strict_val_ops.hpp"
 
 
 namespace slib {
@@ -162,6 +165,65 @@ struct UnaryInv {
 };
 
 
+template <Real T>
+struct UnaryClamp {
+   STRICT_CONSTEXPR explicit UnaryClamp(Strict<T> low, Strict<T> high) : low_{low}, high_{high} {
+   }
+
+   // same as clamps, written as min and max, which compile to instructions without branches
+   STRICT_CONSTEXPR Strict<T> operator()(Strict<T> x) const {
+      if constexpr(Floating<T>) {
+         ASSERT_STRICT_DEBUG(!isnans(x));
+      }
+      return maxs(mins(x, high_), low_);
+   }
+
+private:
+   Strict<T> low_;
+   Strict<T> high_;
+};
+
+
+// replacements are selected without branches
+template <StandardFloating T>
+struct UnaryNanToNum {
+   STRICT_CONSTEXPR explicit UnaryNanToNum(Strict<T> nan, Strict<T> posinf, Strict<T> neginf)
+       : nan_{nan},
+         posinf_{posinf},
+         neginf_{neginf} {
+   }
+
+   STRICT_CONSTEXPR Strict<T> operator()(Strict<T> x) const {
+      const T v = x.val();
+      T r = v != v ? nan_.val() : v;
+      r = v == std::numeric_limits<T>::infinity() ? posinf_.val() : r;
+      r = v == -std::numeric_limits<T>::infinity() ? neginf_.val() : r;
+      return Strict{r};
+   }
+
+private:
+   Strict<T> nan_;
+   Strict<T> posinf_;
+   Strict<T> neginf_;
+};
+
+
+// c ? x : y, where y is fixed
+template <Builtin T>
+struct UnarySelect {
+   STRICT_CONSTEXPR explicit UnarySelect(Strict<T> x, Strict<T> y) : x_{x}, y_{y} {
+   }
+
+   STRICT_CONSTEXPR Strict<T> operator()(StrictBool c) const {
+      return c.val() ? x_ : y_;
+   }
+
+private:
+   Strict<T> x_;
+   Strict<T> y_;
+};
+
+
 template <Builtin T>
 struct UnaryCast {
    template <Builtin U>
@@ -196,6 +258,22 @@ struct BinaryMult {
 };
 
 
+struct BinaryMin {
+   template <Real T>
+   STRICT_CONSTEXPR Strict<T> operator()(Strict<T> x, Strict<T> y) const {
+      return mins(x, y);
+   }
+};
+
+
+struct BinaryMax {
+   template <Real T>
+   STRICT_CONSTEXPR Strict<T> operator()(Strict<T> x, Strict<T> y) const {
+      return maxs(x, y);
+   }
+};
+
+
 struct BinaryDivide {
    template <Real T>
    STRICT_CONSTEXPR Strict<T> operator()(Strict<T> x, Strict<T> y) const {
@@ -252,6 +330,102 @@ struct BinaryBitwiseXor {
 };
 
 
+// comparisons and logical operations return StrictBool; logical operations
+// evaluate both operands, so that loops over masks do not branch
+struct BinaryEqual {
+   template <Builtin T>
+   STRICT_CONSTEXPR StrictBool operator()(Strict<T> x, Strict<T> y) const {
+      return x == y;
+   }
+};
+
+
+struct BinaryNotEqual {
+   template <Builtin T>
+   STRICT_CONSTEXPR StrictBool operator()(Strict<T> x, Strict<T> y) const {
+      return x != y;
+   }
+};
+
+
+struct BinaryLess {
+   template <Real T>
+   STRICT_CONSTEXPR StrictBool operator()(Strict<T> x, Strict<T> y) const {
+      return x < y;
+   }
+};
+
+
+struct BinaryLessEqual {
+   template <Real T>
+   STRICT_CONSTEXPR StrictBool operator()(Strict<T> x, Strict<T> y) const {
+      return x <= y;
+   }
+};
+
+
+struct BinaryGreater {
+   template <Real T>
+   STRICT_CONSTEXPR StrictBool operator()(Strict<T> x, Strict<T> y) const {
+      return x > y;
+   }
+};
+
+
+struct BinaryGreaterEqual {
+   template <Real T>
+   STRICT_CONSTEXPR StrictBool operator()(Strict<T> x, Strict<T> y) const {
+      return x >= y;
+   }
+};
+
+
+struct BinaryLogicalAnd {
+   template <Boolean T>
+   STRICT_CONSTEXPR StrictBool operator()(Strict<T> x, Strict<T> y) const {
+      return StrictBool{static_cast<bool>(x.val() & y.val())};
+   }
+};
+
+
+struct BinaryLogicalOr {
+   template <Boolean T>
+   STRICT_CONSTEXPR StrictBool operator()(Strict<T> x, Strict<T> y) const {
+      return StrictBool{static_cast<bool>(x.val() | y.val())};
+   }
+};
+
+
+// c ? x : y, where y is fixed
+template <Builtin T>
+struct BinarySelectFirst {
+   STRICT_CONSTEXPR explicit BinarySelectFirst(Strict<T> y) : y_{y} {
+   }
+
+   STRICT_CONSTEXPR Strict<T> operator()(StrictBool c, Strict<T> x) const {
+      return c.val() ? x : y_;
+   }
+
+private:
+   Strict<T> y_;
+};
+
+
+// c ? x : y, where x is fixed
+template <Builtin T>
+struct BinarySelectSecond {
+   STRICT_CONSTEXPR explicit BinarySelectSecond(Strict<T> x) : x_{x} {
+   }
+
+   STRICT_CONSTEXPR Strict<T> operator()(StrictBool c, Strict<T> y) const {
+      return c.val() ? x_ : y;
+   }
+
+private:
+   Strict<T> x_;
+};
+
+
 struct BinaryTwoProdFirst {
    template <Floating T>
    Strict<T> operator()(Strict<T> x, Strict<T> y) const {
@@ -268,5 +442,15 @@ struct BinaryTwoProdSecond {
 };
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// both alternatives are evaluated, so that selection compiles to blend instructions
+struct TernarySelect {
+   template <Builtin T>
+   STRICT_CONSTEXPR Strict<T> operator()(StrictBool c, Strict<T> x, Strict<T> y) const {
+      return c.val() ? x : y;
+   }
+};
+
+
 }  // namespace slib
 
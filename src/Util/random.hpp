@@ -6,10 +6,13 @@
 #pragma once
 
 
-#include <random>
+#include <algorithm>  // min
+#include <cstdint>    // uint64_t
+#include <limits>     // numeric_limits
 
 #include "../Common/common.hpp"
 #include "../Expr/array_expr1D.hpp"
+#include "random_engine.hpp"
 
 
 namespace slib {
@@ -18,98 +21,144 @@ namespace slib {
 namespace internal {
 
 
-template <typename T>
-struct Generator;
+// uniformly distributed in [0, 1)
+template <StandardFloating T>
+STRICT_CONSTEXPR_INLINE T unit_real(std::uint64_t x) {
+   constexpr int digits = std::numeric_limits<T>::digits < 64 ? std::numeric_limits<T>::digits : 64;
+   constexpr T scale = [] {
+      T s = 1;
+      for(int k = 0; k < digits; ++k) {
+         s /= 2;
+      }
+      return s;
+   }();
+   return static_cast<T>(x >> (64 - digits)) * scale;
+}
 
 
-template <Integer T>
-struct Generator<T> {
-   Generator(Strict<T> l, Strict<T> h) : gen{std::random_device{}()}, dst{l.val(), h.val()} {
+// uniformly distributed in [l, h], computed with the nearly divisionless method of Lemire
+template <Integer T, typename G>
+STRICT_CONSTEXPR_INLINE T uniform_int(G& g, T l, T h) {
+   using U = std::uint64_t;
+   const U range = static_cast<U>(h) - static_cast<U>(l) + 1;
+   if(range == 0) {
+      return static_cast<T>(g());
    }
 
-   auto random() const {
-      return Strict{dst(gen)};
+#ifdef __SIZEOF_INT128__
+   auto m = static_cast<unsigned __int128>(g()) * range;
+   if(static_cast<U>(m) < range) {
+      const U t = -range % range;
+      while(static_cast<U>(m) < t) {
+         m = static_cast<unsigned __int128>(g()) * range;
+      }
    }
-
-private:
-   mutable std::mt19937 gen;
-   mutable std::uniform_int_distribution<T> dst;
-};
+   return static_cast<T>(static_cast<U>(l) + static_cast<U>(m >> 64));
+#else
+   const U limit = std::numeric_limits<U>::max() - std::numeric_limits<U>::max() % range;
+   U x = g();
+   while(x >= limit) {
+      x = g();
+   }
+   return static_cast<T>(static_cast<U>(l) + x % range);
+#endif
+}
 
 
-template <Boolean T>
-struct Generator<T> {
-   Generator(Strict<T> l, Strict<T> h) : gen{std::random_device{}()}, dst{l.val(), h.val()} {
+// g returns uniformly distributed 64-bit integers
+template <Builtin T, typename G>
+STRICT_CONSTEXPR_INLINE Strict<T> uniform(G& g, Strict<T> low, Strict<T> high) {
+   if constexpr(Boolean<T>) {
+      return uniform_int(g, int{low.val()}, int{high.val()}) % 2 == 0 ? false_sb : true_sb;
+   } else if constexpr(Integer<T>) {
+      return Strict{uniform_int(g, low.val(), high.val())};
+   } else if constexpr(StandardFloating<T>) {
+      return low + (high - low) * Strict{unit_real<T>(g())};
+   } else {
+      // generates quadruple precision numbers that are double precision numbers
+      return uniform(g, low.sd(), high.sd()).sq();
    }
+}
 
-   auto random() const {
-      return dst(gen) % 2 == 0 ? false_sb : true_sb;
-   }
 
-private:
-   mutable std::mt19937 gen;
-   mutable std::uniform_int_distribution<int> dst;
-};
+template <Real T, typename G>
+STRICT_CONSTEXPR_INLINE Strict<T> uniform_not0(G& g, Strict<T> low, Strict<T> high) {
+   while(true) {
+      if(auto r = uniform(g, low, high); r != Zero<T>) {
+         return r;
+      }
+   }
+}
 
 
-template <StandardFloating T>
-struct Generator<T> {
-   Generator(Strict<T> l, Strict<T> h) : gen{std::random_device{}()}, dst{l.val(), h.val()} {
-   }
+// number of elements generated by one task
+static constexpr inline long int random_chunk = 1L << 14;
 
-   auto random() const {
-      return Strict{dst(gen)};
-   }
 
-private:
-   mutable std::mt19937 gen;
-   mutable std::uniform_real_distribution<T> dst;
-};
+// A.index(i) = f(rs, i) for all i; chunks are independent of the number of threads
+template <typename Base, typename F>
+void generate_random(Base& A, const RandomStream& rs, F f) {
+   const long int n = A.size().val();
+   parallel_for_range(n, random_chunk, [&](long int first, long int last) {
+      for(long int i = first; i < last; ++i) {
+         A.index(i) = f(rs, static_cast<std::uint64_t>(i));
+      }
+   });
+}
 
 
-// generates quadruple precision numbers that are double precision numbers
-#ifdef STRICT_QUAD_PRECISION
-template <Quadruple T>
-struct Generator<T> {
-   Generator(Strict<T> l, Strict<T> h) : gen{std::random_device{}()}, dst{l.sd().val(), h.sd().val()} {
+template <Builtin T>
+auto uniform_op(Strict<T> low, Strict<T> high) {
+   if constexpr(StandardFloating<T>) {
+      // the first random number is sufficient, which keeps the loop simple
+      return [low, high](const RandomStream& rs, std::uint64_t i) {
+         return low + (high - low) * Strict{unit_real<T>(rs(i))};
+      };
+   } else {
+      return [low, high](const RandomStream& rs, std::uint64_t i) {
+         ElementBits g{rs, i};
+         return uniform(g, low, high);
+      };
    }
+}
 
-   auto random() const {
-      return Strict{dst(gen)}.sq();
-   }
 
-private:
-   mutable std::mt19937 gen;
-   mutable std::uniform_real_distribution<double> dst;
-};
-#endif
+template <Real T>
+auto uniform_not0_op(Strict<T> low, Strict<T> high) {
+   return [low, high](const RandomStream& rs, std::uint64_t i) {
+      ElementBits g{rs, i};
+      return uniform_not0(g, low, high);
+   };
+}
+
+
+// lazy expression, which is a pure function of the index, so that it can be copied and evaluated in any order
+template <Builtin T, typename F>
+auto random_expr(ImplicitInt n, RandomStream rs, F f) {
+   return generate1D(irange(n), [rs, f](index_t i) { return f(rs, static_cast<std::uint64_t>(i.val())); });
+}
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <Builtin T>
 Strict<T> rands(Strict<T> low, Strict<T> high) {
    ASSERT_STRICT_DEBUG(low <= high);
-   Generator<T> g{low, high};
-   return g.random();
+   return uniform(thread_engine(), low, high);
 }
 
 
 template <typename Base>
    requires NonConstBaseType<RemoveRef<Base>>
-void random(Base&& A, ValueTypeOf<Base> low, ValueTypeOf<Base> high) {
+void random(Base&& A, ValueTypeOf<Base> low, ValueTypeOf<Base> high, std::uint64_t seed, std::uint32_t stream) {
    ASSERT_STRICT_DEBUG(low <= high);
-   Generator<BuiltinTypeOf<Base>> g{low, high};
-   for(auto& x : A) {
-      x = g.random();
-   }
+   generate_random(A, RandomStream{seed, stream}, uniform_op(low, high));
 }
 
 
 template <Builtin T>
-auto random(ImplicitInt n, Strict<T> low, Strict<T> high) {
+auto random(ImplicitInt n, Strict<T> low, Strict<T> high, std::uint64_t seed, std::uint32_t stream) {
    ASSERT_STRICT_DEBUG(low <= high);
-   Generator<T> g{low, high};
-   auto G = [g]([[maybe_unused]] auto x) { return g.random(); };
-   return generate1D<decltype(const1D<T>(n, Zero<T>)), decltype(G), true>(const1D<T>(n, Zero<T>), G);
+   return random_expr<T>(n, RandomStream{seed, stream}, uniform_op(low, high));
 }
 
 
@@ -118,48 +167,25 @@ template <Real T>
 Strict<T> rands_not0(Strict<T> low, Strict<T> high) {
    ASSERT_STRICT_DEBUG(low <= high);
    ASSERT_STRICT_DEBUG(!(low == Zero<T> && high == Zero<T>));
-
-   Generator<T> g{low, high};
-   while(true) {
-      if(auto r = g.random(); r != Zero<T>) {
-         return r;
-      }
-   }
+   return uniform_not0(thread_engine(), low, high);
 }
 
 
 template <typename Base>
    requires NonConstBaseType<RemoveRef<Base>> && Real<BuiltinTypeOf<Base>>
-void random_not0(Base&& A, ValueTypeOf<Base> low, ValueTypeOf<Base> high) {
+void random_not0(Base&& A, ValueTypeOf<Base> low, ValueTypeOf<Base> high, std::uint64_t seed,
+                 std::uint32_t stream) {
    ASSERT_STRICT_DEBUG(low <= high);
    ASSERT_STRICT_DEBUG(!(low == Zero<RealTypeOf<Base>> && high == Zero<RealTypeOf<Base>>));
-
-   Generator<RealTypeOf<Base>> g{low, high};
-   for(auto& x : A) {
-      while(true) {
-         if(auto r = g.random(); r != Zero<RealTypeOf<Base>>) {
-            x = r;
-            break;
-         }
-      }
-   }
+   generate_random(A, RandomStream{seed, stream}, uniform_not0_op(low, high));
 }
 
 
 template <Real T>
-auto random_not0(ImplicitInt n, Strict<T> low, Strict<T> high) {
+auto random_not0(ImplicitInt n, Strict<T> low, Strict<T> high, std::uint64_t seed, std::uint32_t stream) {
    ASSERT_STRICT_DEBUG(low <= high);
    ASSERT_STRICT_DEBUG(!(low == Zero<T> && high == Zero<T>));
-
-   Generator<T> g{low, high};
-   auto G = [g]([[maybe_unused]] auto x) {
-      while(true) {
-         if(auto r = g.random(); r != Zero<T>) {
-            return r;
-         }
-      }
-   };
-   return generate1D<decltype(const1D<T>(n, Zero<T>)), decltype(G), true>(const1D<T>(n, Zero<T>), G);
+   return random_expr<T>(n, RandomStream{seed, stream}, uniform_not0_op(low, high));
 }
 
 
@@ -205,17 +231,28 @@ Strict<T> rands_not0() {
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions that take seed and stream generate the same values on every run and on any number of
+// threads. Element i of the result depends only on seed, stream, and i. Other functions use a seed
+// drawn from a thread-local engine. Arrays are filled in parallel.
+template <typename Base>
+   requires NonConstBaseType<RemoveRef<Base>> && Real<BuiltinTypeOf<Base>>
+void random(Base&& A, ValueTypeOf<Base> low, ValueTypeOf<Base> high, std::uint64_t seed,
+            std::uint32_t stream = 0) {
+   internal::random(A, low, high, seed, stream);
+}
+
+
 template <typename Base>
    requires NonConstBaseType<RemoveRef<Base>> && Real<BuiltinTypeOf<Base>>
 void random(Base&& A, ValueTypeOf<Base> low, ValueTypeOf<Base> high) {
-   internal::random(A, low, high);
+   internal::random(A, low, high, internal::thread_engine()(), 0);
 }
 
 
 template <typename Base>
    requires NonConstBaseType<RemoveRef<Base>> && Real<BuiltinTypeOf<Base>>
 void random(Base&& A, Low<BuiltinTypeOf<Base>> low, High<BuiltinTypeOf<Base>> high) {
-   internal::random(A, low.get(), high.get());
+   internal::random(A, low.get(), high.get(), internal::thread_engine()(), 0);
 }
 
 
@@ -223,22 +260,30 @@ template <typename... Base>
    requires AllNonConstBases<RemoveRef<Base>...>
 void random(Base&&... A) {
    using T = RealTypeOf<LastPack_t<Base...>>;
-   (..., internal::random(A, Zero<T>, One<T>));
+   (..., internal::random(A, Zero<T>, One<T>, internal::thread_engine()(), 0));
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename Base>
+   requires NonConstBaseType<RemoveRef<Base>> && Real<BuiltinTypeOf<Base>>
+void random_not0(Base&& A, ValueTypeOf<Base> low, ValueTypeOf<Base> high, std::uint64_t seed,
+                 std::uint32_t stream = 0) {
+   internal::random_not0(A, low, high, seed, stream);
+}
+
+
 template <typename Base>
    requires NonConstBaseType<RemoveRef<Base>> && Real<BuiltinTypeOf<Base>>
 void random_not0(Base&& A, ValueTypeOf<Base> low, ValueTypeOf<Base> high) {
-   internal::random_not0(A, low, high);
+   internal::random_not0(A, low, high, internal::thread_engine()(), 0);
 }
 
 
 template <typename Base>
    requires NonConstBaseType<RemoveRef<Base>> && Real<BuiltinTypeOf<Base>>
 void random_not0(Base&& A, Low<BuiltinTypeOf<Base>> low, High<BuiltinTypeOf<Base>> high) {
-   internal::random_not0(A, low.get(), high.get());
+   internal::random_not0(A, low.get(), high.get(), internal::thread_engine()(), 0);
 }
 
 
@@ -246,14 +291,20 @@ template <typename... Base>
    requires AllNonConstBases<RemoveRef<Base>...> && Real<BuiltinTypeOf<LastPack_t<Base...>>>
 void random_not0(Base&&... A) {
    using T = RealTypeOf<LastPack_t<Base...>>;
-   (..., internal::random_not0(A, Zero<T>, One<T>));
+   (..., internal::random_not0(A, Zero<T>, One<T>, internal::thread_engine()(), 0));
 }
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <Real T>
+auto random(ImplicitInt n, Strict<T> low, Strict<T> high, std::uint64_t seed, std::uint32_t stream = 0) {
+   return internal::random<T>(n, low, high, seed, stream);
+}
+
+
 template <Real T>
 auto random(ImplicitInt n, Strict<T> low, Strict<T> high) {
-   return internal::random<T>(n, low, high);
+   return internal::random<T>(n, low, high, internal::thread_engine()(), 0);
 }
 
 
@@ -263,9 +314,15 @@ auto random(Size n, Low<T> low, High<T> high) {
 }
 
 
+template <Builtin T>
+auto random(ImplicitInt n, std::uint64_t seed, std::uint32_t stream = 0) {
+   return internal::random<T>(n, Zero<T>, One<T>, seed, stream);
+}
+
+
 template <Builtin T>
 auto random(ImplicitInt n) {
-   return internal::random<T>(n, Zero<T>, One<T>);
+   return internal::random<T>(n, Zero<T>, One<T>, internal::thread_engine()(), 0);
 }
 
 
@@ -276,9 +333,15 @@ auto random(Size n) {
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <Real T>
+auto random_not0(ImplicitInt n, Strict<T> low, Strict<T> high, std::uint64_t seed, std::uint32_t stream = 0) {
+   return internal::random_not0<T>(n, low, high, seed, stream);
+}
+
+
 template <Real T>
 auto random_not0(ImplicitInt n, Strict<T> low, Strict<T> high) {
-   return internal::random_not0<T>(n, low, high);
+   return internal::random_not0<T>(n, low, high, internal::thread_engine()(), 0);
 }
 
 
@@ -288,9 +351,15 @@ auto random_not0(Size n, Low<T> low, High<T> high) {
 }
 
 
+template <Real T>
+auto random_not0(ImplicitInt n, std::uint64_t seed, std::uint32_t stream = 0) {
+   return internal::random_not0<T>(n, Zero<T>, One<T>, seed, stream);
+}
+
+
 template <Real T>
 auto random_not0(ImplicitInt n) {
-   return internal::random_not0<T>(n, Zero<T>, One<T>);
+   return internal::random_not0<T>(n, Zero<T>, One<T>, internal::thread_engine()(), 0);
 }
 
 
@@ -0,0 +1,404 @@
+//  Copyright (C) 2024 Arkadijs Slobodkins - All Rights Reserved
+// License is 3-clause BSD:
+// https://github.com/arkslobodkins/strict-lib
+
+
+#pragma once
+
+
+#include <cmath>        // cos, exp, floor, log, sqrt
+#include <cstdint>      // uint32_t, uint64_t
+#include <numbers>      // pi
+#include <type_traits>  // conditional_t
+
+#include "../Common/common.hpp"
+#include "random.hpp"
+
+
+// Non-uniform distributions. Like uniform random arrays, elements are pure functions of
+// seed, stream, and index, and are generated in parallel. Normal, log-normal, and exponential
+// numbers use one Philox block per element and no branches(Box-Muller and inversion), so that
+// the generation loops can be vectorized. Poisson and truncated normal numbers use rejection.
+namespace slib {
+
+
+namespace internal {
+
+
+// quadruple precision numbers are generated in double precision
+template <Floating T>
+using DistributionType = std::conditional_t<StandardFloating<T>, T, double>;
+
+
+template <Floating T>
+STRICT_CONSTEXPR_INLINE Strict<T> to_strict(DistributionType<T> x) {
+   if constexpr(StandardFloating<T>) {
+      return Strict{x};
+   } else {
+      return Strict{x}.sq();
+   }
+}
+
+
+// uniformly distributed in (0, 1]
+template <StandardFloating T>
+STRICT_CONSTEXPR_INLINE T unit_real_not0(std::uint64_t x) {
+   return T(1) - unit_real<T>(x);
+}
+
+
+// standard normal number computed by Box-Muller transform
+template <StandardFloating T>
+STRICT_INLINE T box_muller(std::uint64_t x1, std::uint64_t x2) {
+   return std::sqrt(T(-2) * std::log(unit_real_not0<T>(x1))) * std::cos(T(2) * std::numbers::pi_v<T> * unit_real<T>(x2));
+}
+
+
+template <StandardFloating T, typename G>
+STRICT_INLINE T standard_normal(G& g) {
+   const auto x1 = g();
+   return box_muller<T>(x1, g());
+}
+
+
+// standard normal number truncated to [a, b], computed by rejection from normal, uniform, or
+// exponential distribution(Robert, "Simulation of truncated normal variables", 1995)
+template <StandardFloating T, typename G>
+T truncated_standard_normal(G& g, T a, T b) {
+   if(b <= T(0)) {
+      return -truncated_standard_normal<T>(g, -b, -a);
+   }
+
+   const T w = b - a;
+   // closest point to 0
+   const T z0 = a > T(0) ? a : T(0);
+
+   if(w <= T(2.5) && (a <= T(0) || w * a <= T(1))) {
+      while(true) {
+         const T z = a + w * unit_real<T>(g());
+         if(unit_real<T>(g()) <= std::exp((z0 * z0 - z * z) / T(2))) {
+            return z;
+         }
+      }
+   }
+
+   if(a < T(0.5)) {
+      while(true) {
+         if(const T z = standard_normal<T>(g); z >= a && z <= b) {
+            return z;
+         }
+      }
+   }
+
+   const T alpha = (a + std::sqrt(a * a + T(4))) / T(2);
+   while(true) {
+      const T z = a - std::log(unit_real_not0<T>(g())) / alpha;
+      if(z <= b && unit_real<T>(g()) <= std::exp(-(z - alpha) * (z - alpha) / T(2))) {
+         return z;
+      }
+   }
+}
+
+
+// log(k!)
+STRICT_INLINE double log_factorial(long int k) {
+   constexpr double table[] = {0.,
+                               0.,
+                               0.69314718055994531,
+                               1.791759469228055,
+                               3.1780538303479458,
+                               4.7874917427820458,
+                               6.5792512120101012,
+                               8.5251613610654147,
+                               10.604602902745251,
+                               12.801827480081469};
+   if(k < 10) {
+      return table[k];
+   }
+   // Stirling series
+   const double x = static_cast<double>(k) + 1.;
+   const double r = 1. / (x * x);
+   return (x - 0.5) * std::log(x) - x + 0.91893853320467274
+        + (1. / 12. - r * (1. / 360. - r * (1. / 1260. - r / 1680.))) / x;
+}
+
+
+// Poisson number computed by inversion for small lambda and by transformed rejection with
+// squeeze(Hormann, "The transformed rejection method for generating Poisson random variables", 1993)
+template <typename G>
+long int poisson(G& g, double lambda) {
+   if(lambda < 10.) {
+      const double u = unit_real<double>(g());
+      double p = std::exp(-lambda);
+      double F = p;
+      long int k = 0;
+      // the bound protects from rounding errors in F
+      while(u > F && k < 1000) {
+         ++k;
+         p *= lambda / static_cast<double>(k);
+         F += p;
+      }
+      return k;
+   }
+
+   const double slam = std::sqrt(lambda);
+   const double loglam = std::log(lambda);
+   const double b = 0.931 + 2.53 * slam;
+   const double a = -0.059 + 0.02483 * b;
+   const double invalpha = 1.1239 + 1.1328 / (b - 3.4);
+   const double vr = 0.9277 - 3.6224 / (b - 2.);
+
+   while(true) {
+      const double U = unit_real<double>(g()) - 0.5;
+      const double V = unit_real<double>(g());
+      const double us = 0.5 - std::abs(U);
+      const auto k = static_cast<long int>(std::floor((2. * a / us + b) * U + lambda + 0.43));
+      if(us >= 0.07 && V <= vr) {
+         return k;
+      }
+      if(k < 0 || (us < 0.013 && V > us)) {
+         continue;
+      }
+      if(std::log(V) + std::log(invalpha) - std::log(a / (us * us) + b)
+         <= -lambda + static_cast<double>(k) * loglam - log_factorial(k)) {
+         return k;
+      }
+   }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <Floating T>
+auto normal_op(Strict<T> mu, Strict<T> sigma) {
+   using W = DistributionType<T>;
+   return [m = W(mu.val()), s = W(sigma.val())](const RandomStream& rs, std::uint64_t i) {
+      auto r = rs.block(i, 0);
+      const W z = box_muller<W>(std::uint64_t{r[0]} | (std::uint64_t{r[1]} << 32),
+                                std::uint64_t{r[2]} | (std::uint64_t{r[3]} << 32));
+      return to_strict<T>(m + s * z);
+   };
+}
+
+
+template <Floating T>
+auto lognormal_op(Strict<T> mu, Strict<T> sigma) {
+   using W = DistributionType<T>;
+   return [m = W(mu.val()), s = W(sigma.val())](const RandomStream& rs, std::uint64_t i) {
+      auto r = rs.block(i, 0);
+      const W z = box_muller<W>(std::uint64_t{r[0]} | (std::uint64_t{r[1]} << 32),
+                                std::uint64_t{r[2]} | (std::uint64_t{r[3]} << 32));
+      return to_strict<T>(std::exp(m + s * z));
+   };
+}
+
+
+template <Floating T>
+auto exponential_op(Strict<T> lambda) {
+   using W = DistributionType<T>;
+   return [l = W(lambda.val())](const RandomStream& rs, std::uint64_t i) {
+      return to_strict<T>(-std::log(unit_real_not0<W>(rs(i))) / l);
+   };
+}
+
+
+template <Floating T>
+auto truncated_normal_op(Strict<T> mu, Strict<T> sigma, Strict<T> low, Strict<T> high) {
+   using W = DistributionType<T>;
+   const W m = W(mu.val());
+   const W s = W(sigma.val());
+   return [m, s, a = (W(low.val()) - m) / s, b = (W(high.val()) - m) / s](const RandomStream& rs,
+                                                                          std::uint64_t i) {
+      ElementBits g{rs, i};
+      return to_strict<T>(m + s * truncated_standard_normal<W>(g, a, b));
+   };
+}
+
+
+template <Integer T>
+auto poisson_op(Strict64 lambda) {
+   return [l = lambda.val()](const RandomStream& rs, std::uint64_t i) {
+      ElementBits g{rs, i};
+      return Strict{static_cast<T>(poisson(g, l))};
+   };
+}
+
+
+}  // namespace internal
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Functions that take seed and stream generate the same values on every run and on any number of
+// threads. Other functions use a seed drawn from a thread-local engine. Functions that take size
+// return lazy expressions, which produce the same values each time they are evaluated.
+template <typename Base>
+   requires NonConstBaseType<RemoveRef<Base>> && Floating<BuiltinTypeOf<Base>>
+void random_normal(Base&& A, ValueTypeOf<Base> mu, ValueTypeOf<Base> sigma, std::uint64_t seed,
+                   std::uint32_t stream = 0) {
+   ASSERT_STRICT_DEBUG(sigma > Zero<RealTypeOf<Base>>);
+   internal::generate_random(A, RandomStream{seed, stream}, internal::normal_op(mu, sigma));
+}
+
+
+template <typename Base>
+   requires NonConstBaseType<RemoveRef<Base>> && Floating<BuiltinTypeOf<Base>>
+void random_normal(Base&& A, ValueTypeOf<Base> mu, ValueTypeOf<Base> sigma) {
+   random_normal(A, mu, sigma, internal::thread_engine()());
+}
+
+
+template <typename Base>
+   requires NonConstBaseType<RemoveRef<Base>> && Floating<BuiltinTypeOf<Base>>
+void random_normal(Base&& A) {
+   using T = RealTypeOf<Base>;
+   random_normal(A, Zero<T>, One<T>);
+}
+
+
+template <Floating T>
+auto random_normal(ImplicitInt n, Strict<T> mu, Strict<T> sigma, std::uint64_t seed, std::uint32_t stream = 0) {
+   ASSERT_STRICT_DEBUG(sigma > Zero<T>);
+   return internal::random_expr<T>(n, RandomStream{seed, stream}, internal::normal_op(mu, sigma));
+}
+
+
+template <Floating T>
+auto random_normal(ImplicitInt n, Strict<T> mu, Strict<T> sigma) {
+   return random_normal<T>(n, mu, sigma, internal::thread_engine()());
+}
+
+
+template <Floating T>
+auto random_normal(ImplicitInt n) {
+   return random_normal<T>(n, Zero<T>, One<T>);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// normal distribution with mean mu and standard deviation sigma, truncated to [low, high]
+template <typename Base>
+   requires NonConstBaseType<RemoveRef<Base>> && Floating<BuiltinTypeOf<Base>>
+void random_truncated_normal(Base&& A, ValueTypeOf<Base> mu, ValueTypeOf<Base> sigma, ValueTypeOf<Base> low,
+                             ValueTypeOf<Base> high, std::uint64_t seed, std::uint32_t stream = 0) {
+   ASSERT_STRICT_DEBUG(sigma > Zero<RealTypeOf<Base>>);
+   ASSERT_STRICT_DEBUG(low < high);
+   internal::generate_random(A, RandomStream{seed, stream}, internal::truncated_normal_op(mu, sigma, low, high));
+}
+
+
+template <typename Base>
+   requires NonConstBaseType<RemoveRef<Base>> && Floating<BuiltinTypeOf<Base>>
+void random_truncated_normal(Base&& A, ValueTypeOf<Base> mu, ValueTypeOf<Base> sigma, ValueTypeOf<Base> low,
+                             ValueTypeOf<Base> high) {
+   random_truncated_normal(A, mu, sigma, low, high, internal::thread_engine()());
+}
+
+
+template <Floating T>
+auto random_truncated_normal(ImplicitInt n, Strict<T> mu, Strict<T> sigma, Strict<T> low, Strict<T> high,
+                             std::uint64_t seed, std::uint32_t stream = 0) {
+   ASSERT_STRICT_DEBUG(sigma > Zero<T>);
+   ASSERT_STRICT_DEBUG(low < high);
+   return internal::random_expr<T>(n, RandomStream{seed, stream},
+                                   internal::truncated_normal_op(mu, sigma, low, high));
+}
+
+
+template <Floating T>
+auto random_truncated_normal(ImplicitInt n, Strict<T> mu, Strict<T> sigma, Strict<T> low, Strict<T> high) {
+   return random_truncated_normal<T>(n, mu, sigma, low, high, internal::thread_engine()());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// exp(X), where X is normally distributed with mean mu and standard deviation sigma
+template <typename Base>
+   requires NonConstBaseType<RemoveRef<Base>> && Floating<BuiltinTypeOf<Base>>
+void random_lognormal(Base&& A, ValueTypeOf<Base> mu, ValueTypeOf<Base> sigma, std::uint64_t seed,
+                      std::uint32_t stream = 0) {
+   ASSERT_STRICT_DEBUG(sigma > Zero<RealTypeOf<Base>>);
+   internal::generate_random(A, RandomStream{seed, stream}, internal::lognormal_op(mu, sigma));
+}
+
+
+template <typename Base>
+   requires NonConstBaseType<RemoveRef<Base>> && Floating<BuiltinTypeOf<Base>>
+void random_lognormal(Base&& A, ValueTypeOf<Base> mu, ValueTypeOf<Base> sigma) {
+   random_lognormal(A, mu, sigma, internal::thread_engine()());
+}
+
+
+template <Floating T>
+auto random_lognormal(ImplicitInt n, Strict<T> mu, Strict<T> sigma, std::uint64_t seed,
+                      std::uint32_t stream = 0) {
+   ASSERT_STRICT_DEBUG(sigma > Zero<T>);
+   return internal::random_expr<T>(n, RandomStream{seed, stream}, internal::lognormal_op(mu, sigma));
+}
+
+
+template <Floating T>
+auto random_lognormal(ImplicitInt n, Strict<T> mu, Strict<T> sigma) {
+   return random_lognormal<T>(n, mu, sigma, internal::thread_engine()());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// lambda is the rate, i.e. the mean is 1 / lambda
+template <typename Base>
+   requires NonConstBaseType<RemoveRef<Base>> && Floating<BuiltinTypeOf<Base>>
+void random_exponential(Base&& A, ValueTypeOf<Base> lambda, std::uint64_t seed, std::uint32_t stream = 0) {
+   ASSERT_STRICT_DEBUG(lambda > Zero<RealTypeOf<Base>>);
+   internal::generate_random(A, RandomStream{seed, stream}, internal::exponential_op(lambda));
+}
+
+
+template <typename Base>
+   requires NonConstBaseType<RemoveRef<Base>> && Floating<BuiltinTypeOf<Base>>
+void random_exponential(Base&& A, ValueTypeOf<Base> lambda) {
+   random_exponential(A, lambda, internal::thread_engine()());
+}
+
+
+template <Floating T>
+auto random_exponential(ImplicitInt n, Strict<T> lambda, std::uint64_t seed, std::uint32_t stream = 0) {
+   ASSERT_STRICT_DEBUG(lambda > Zero<T>);
+   return internal::random_expr<T>(n, RandomStream{seed, stream}, internal::exponential_op(lambda));
+}
+
+
+template <Floating T>
+auto random_exponential(ImplicitInt n, Strict<T> lambda) {
+   return random_exponential<T>(n, lambda, internal::thread_engine()());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// lambda is the mean
+template <typename Base>
+   requires NonConstBaseType<RemoveRef<Base>> && Integer<BuiltinTypeOf<Base>>
+void random_poisson(Base&& A, Strict64 lambda, std::uint64_t seed, std::uint32_t stream = 0) {
+   ASSERT_STRICT_DEBUG(lambda >= 0._sd);
+   internal::generate_random(A, RandomStream{seed, stream}, internal::poisson_op<BuiltinTypeOf<Base>>(lambda));
+}
+
+
+template <typename Base>
+   requires NonConstBaseType<RemoveRef<Base>> && Integer<BuiltinTypeOf<Base>>
+void random_poisson(Base&& A, Strict64 lambda) {
+   random_poisson(A, lambda, internal::thread_engine()());
+}
+
+
+template <Integer T>
+auto random_poisson(ImplicitInt n, Strict64 lambda, std::uint64_t seed, std::uint32_t stream = 0) {
+   ASSERT_STRICT_DEBUG(lambda >= 0._sd);
+   return internal::random_expr<T>(n, RandomStream{seed, stream}, internal::poisson_op<T>(lambda));
+}
+
+
+template <Integer T>
+auto random_poisson(ImplicitInt n, Strict64 lambda) {
+   return random_poisson<T>(n, lambda, internal::thread_engine()());
+}
+
+
+}  // namespace slib
@@ -0,0 +1,304 @@
+//  Copyright (C) 2024 Arkadijs Slobodkins - All Rights Reserved
+// License is 3-clause BSD:
+// https://github.com/arkslobodkins/strict-lib
+
+
+#pragma once
+
+
+#include <array>    // array
+#include <bit>      // rotl
+#include <cstdint>  // uint32_t, uint64_t
+#include <limits>   // numeric_limits
+#include <random>   // random_device
+#include <span>     // span
+
+#include "../Common/common.hpp"
+
+
+// Random number engines. Both engines satisfy std::uniform_random_bit_generator and can be
+// used with the standard library distributions and algorithms.
+// Xoshiro256 is a small and fast sequential engine.
+// Philox4x32 is a counter-based engine: the n-th output is a pure function of the seed, stream,
+// and n, so that any part of the sequence can be computed independently of the rest of it.
+namespace slib {
+
+
+// SplitMix64, used to expand 64-bit seeds into larger states
+STRICT_CONSTEXPR_INLINE std::uint64_t splitmix64(std::uint64_t& x) {
+   std::uint64_t z = (x += 0x9e3779b97f4a7c15);
+   z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+   z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+   return z ^ (z >> 31);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// xoshiro256** 1.0 of Blackman and Vigna, period 2^256 - 1
+class Xoshiro256 {
+public:
+   using result_type = std::uint64_t;
+
+   STRICT_CONSTEXPR explicit Xoshiro256(std::uint64_t seed = 0) {
+      this->seed(seed);
+   }
+
+   STRICT_CONSTEXPR void seed(std::uint64_t seed) {
+      for(auto& x : s_) {
+         x = splitmix64(seed);
+      }
+   }
+
+   STRICT_NODISCARD_CONSTEXPR static result_type min() {
+      return 0;
+   }
+
+   STRICT_NODISCARD_CONSTEXPR static result_type max() {
+      return std::numeric_limits<result_type>::max();
+   }
+
+   STRICT_CONSTEXPR_INLINE result_type operator()() {
+      const auto r = std::rotl(s_[1] * 5, 7) * 9;
+      const auto t = s_[1] << 17;
+      s_[2] ^= s_[0];
+      s_[3] ^= s_[1];
+      s_[1] ^= s_[2];
+      s_[0] ^= s_[3];
+      s_[2] ^= t;
+      s_[3] = std::rotl(s_[3], 45);
+      return r;
+   }
+
+   STRICT_CONSTEXPR void fill(std::span<result_type> s) {
+      // local copy of the state allows compiler to keep it in registers
+      auto g = *this;
+      for(auto& x : s) {
+         x = g();
+      }
+      *this = g;
+   }
+
+   STRICT_CONSTEXPR void discard(unsigned long long n) {
+      for(; n != 0; --n) {
+         (void)(*this)();
+      }
+   }
+
+   // equivalent to 2^128 calls to operator(); can be used to generate
+   // 2^128 non-overlapping sequences for parallel computations
+   STRICT_CONSTEXPR void jump() {
+      constexpr std::uint64_t j[] = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa,
+                                     0x39abdc4529b1661c};
+      std::uint64_t t[4]{};
+      for(auto w : j) {
+         for(int b = 0; b < 64; ++b) {
+            if(w & (std::uint64_t{1} << b)) {
+               for(int k = 0; k < 4; ++k) {
+                  t[k] ^= s_[k];
+               }
+            }
+            (void)(*this)();
+         }
+      }
+      for(int k = 0; k < 4; ++k) {
+         s_[k] = t[k];
+      }
+   }
+
+private:
+   std::uint64_t s_[4];
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Philox4x32-10 of Salmon, Moraes, Dror, and Shaw, "Parallel random numbers: as easy as 1, 2, 3"
+class Philox4x32 {
+public:
+   using result_type = std::uint64_t;
+   using counter_type = std::array<std::uint32_t, 4>;
+   using key_type = std::array<std::uint32_t, 2>;
+
+   // streams with different numbers are independent
+   STRICT_CONSTEXPR explicit Philox4x32(std::uint64_t seed = 0, std::uint64_t stream = 0)
+       : key_{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)},
+         ctr_{0, 0, static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)},
+         buf_{},
+         pos_{2} {
+   }
+
+   STRICT_NODISCARD_CONSTEXPR static result_type min() {
+      return 0;
+   }
+
+   STRICT_NODISCARD_CONSTEXPR static result_type max() {
+      return std::numeric_limits<result_type>::max();
+   }
+
+   // 10 rounds of the bijection that maps counter to random bits for a given key
+   STRICT_NODISCARD_CONSTEXPR_INLINE static counter_type block(counter_type c, key_type k) {
+      for(int r = 0; r < 10; ++r) {
+         if(r != 0) {
+            k[0] += 0x9E3779B9;
+            k[1] += 0xBB67AE85;
+         }
+         const auto p0 = std::uint64_t{0xD2511F53} * c[0];
+         const auto p1 = std::uint64_t{0xCD9E8D57} * c[2];
+         c = {static_cast<std::uint32_t>(p1 >> 32) ^ c[1] ^ k[0], static_cast<std::uint32_t>(p1),
+              static_cast<std::uint32_t>(p0 >> 32) ^ c[3] ^ k[1], static_cast<std::uint32_t>(p0)};
+      }
+      return c;
+   }
+
+   STRICT_CONSTEXPR_INLINE result_type operator()() {
+      if(pos_ == 2) {
+         auto b = block(ctr_, key_);
+         buf_[0] = std::uint64_t{b[0]} | (std::uint64_t{b[1]} << 32);
+         buf_[1] = std::uint64_t{b[2]} | (std::uint64_t{b[3]} << 32);
+         pos_ = 0;
+         this->increment();
+      }
+      return buf_[pos_++];
+   }
+
+   // blocks are independent of each other, so that the main loop vectorizes
+   STRICT_CONSTEXPR void fill(std::span<result_type> s) {
+      std::size_t i = 0;
+      for(; i < s.size() && pos_ != 2; ++i) {
+         s[i] = (*this)();
+      }
+
+      const std::uint64_t first = std::uint64_t{ctr_[0]} | (std::uint64_t{ctr_[1]} << 32);
+      const std::size_t nblocks = (s.size() - i) / 2;
+      for(std::size_t b = 0; b < nblocks; ++b) {
+         const auto n = first + b;
+         auto r = block({static_cast<std::uint32_t>(n), static_cast<std::uint32_t>(n >> 32), ctr_[2], ctr_[3]},
+                        key_);
+         s[i + 2 * b] = std::uint64_t{r[0]} | (std::uint64_t{r[1]} << 32);
+         s[i + 2 * b + 1] = std::uint64_t{r[2]} | (std::uint64_t{r[3]} << 32);
+      }
+      this->set_block(first + nblocks);
+
+      for(i += 2 * nblocks; i < s.size(); ++i) {
+         s[i] = (*this)();
+      }
+   }
+
+   // skips n outputs in constant time
+   STRICT_CONSTEXPR void discard(unsigned long long n) {
+      for(; n != 0 && pos_ != 2; --n) {
+         ++pos_;
+      }
+      const std::uint64_t next = (std::uint64_t{ctr_[0]} | (std::uint64_t{ctr_[1]} << 32)) + n / 2;
+      this->set_block(next);
+      if(n % 2 != 0) {
+         (void)(*this)();
+      }
+   }
+
+private:
+   key_type key_;
+   counter_type ctr_;  // the first two words count blocks, the last two store the stream
+   std::uint64_t buf_[2];
+   int pos_;
+
+   STRICT_CONSTEXPR_INLINE void increment() {
+      if(++ctr_[0] == 0) {
+         ++ctr_[1];
+      }
+   }
+
+   STRICT_CONSTEXPR_INLINE void set_block(std::uint64_t n) {
+      ctr_[0] = static_cast<std::uint32_t>(n);
+      ctr_[1] = static_cast<std::uint32_t>(n >> 32);
+   }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Random numbers indexed by position: k-th random number of element i is a pure function of
+// seed, stream, i, and k. Element i uses Philox blocks with counters (i, stream, k / 2), so that
+// arrays can be generated in any order, in parallel, and with identical results on any number of threads.
+class RandomStream {
+public:
+   STRICT_CONSTEXPR explicit RandomStream(std::uint64_t seed, std::uint32_t stream = 0)
+       : key_{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)},
+         stream_{stream} {
+   }
+
+   STRICT_NODISCARD_CONSTEXPR_INLINE Philox4x32::counter_type block(std::uint64_t i, std::uint32_t b) const {
+      return Philox4x32::block({static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(i >> 32), stream_, b},
+                               key_);
+   }
+
+   // the first random number of element i
+   STRICT_NODISCARD_CONSTEXPR_INLINE std::uint64_t operator()(std::uint64_t i) const {
+      auto r = this->block(i, 0);
+      return std::uint64_t{r[0]} | (std::uint64_t{r[1]} << 32);
+   }
+
+private:
+   Philox4x32::key_type key_;
+   std::uint32_t stream_;
+};
+
+
+namespace internal {
+
+
+// sequence of random numbers of element i, for distributions that need more than one number per element
+class ElementBits {
+public:
+   using result_type = std::uint64_t;
+
+   STRICT_CONSTEXPR_INLINE ElementBits(const RandomStream& rs, std::uint64_t i) : rs_{rs}, i_{i}, k_{0}, buf_{} {
+   }
+
+   STRICT_NODISCARD_CONSTEXPR static result_type min() {
+      return 0;
+   }
+
+   STRICT_NODISCARD_CONSTEXPR static result_type max() {
+      return std::numeric_limits<result_type>::max();
+   }
+
+   STRICT_CONSTEXPR_INLINE result_type operator()() {
+      if(k_ % 2 == 0) {
+         buf_ = rs_.block(i_, k_ / 2);
+      }
+      const auto w = 2 * (k_++ % 2);
+      return std::uint64_t{buf_[w]} | (std::uint64_t{buf_[w + 1]} << 32);
+   }
+
+private:
+   const RandomStream& rs_;
+   std::uint64_t i_;
+   std::uint32_t k_;
+   Philox4x32::counter_type buf_;
+};
+
+
+}  // namespace internal
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// seeds that are different in each call and in each thread
+STRICT_INLINE std::uint64_t random_seed() {
+   std::random_device rd;
+   return (std::uint64_t{rd()} << 32) ^ rd();
+}
+
+
+namespace internal {
+
+
+// seeded once per thread, so that generating random numbers does not involve std::random_device
+STRICT_INLINE Xoshiro256& thread_engine() {
+   thread_local Xoshiro256 engine{random_seed()};
+   return engine;
+}
+
+
+}  // namespace internal
+
+
+}  // namespace slib
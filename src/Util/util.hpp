@@ -8,4 +8,5 @@
 
 #include "error_tools.hpp"
 #include "random.hpp"
+#include "random_distributions.hpp"
 #include "timer.hpp"
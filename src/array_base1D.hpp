@@ -6,7 +6,9 @@
 #pragma once
 
 
+#include <functional>        // function
 #include <initializer_list>  // initializer_list
+#include <memory>            // unique_ptr
 #include <new>               // align_val_t
 #include <type_traits>       // is_constant_evaluated
 #include <utility>           // move, forward, swap, exchange
@@ -25,6 +27,28 @@ template <Builtin T, AlignmentFlag AF>
 class ArrayBase1D;
 
 
+namespace internal {
+
+struct Adopt {};
+
+
+// heap copy of deleter, which is stored by pointer so that arrays that do not adopt data stay small;
+// data is released by deleter if the copy cannot be allocated
+template <Builtin T>
+std::function<void(T*)>* adopt_deleter(T* data, std::function<void(T*)>& deleter) {
+   try {
+      return new std::function<void(T*)>(std::move(deleter));
+   } catch(...) {
+      if(deleter) {
+         deleter(data);
+      }
+      throw;
+   }
+}
+
+}  // namespace internal
+
+
 template <typename D> concept Array1DType = OneDimBaseType<D>
                                          && (DerivedFrom<D, ArrayBase1D<BuiltinTypeOf<D>, Aligned>>
                                              || DerivedFrom<D, ArrayBase1D<BuiltinTypeOf<D>, Unaligned>>);
@@ -51,6 +75,9 @@ public:
    template <LinearIteratorType L>
    STRICT_NODISCARD_CONSTEXPR explicit ArrayBase1D(L b, L e);
 
+   // takes ownership of data, which is released by calling deleter(data)
+   STRICT_NODISCARD explicit ArrayBase1D(internal::Adopt, T* data, ImplicitInt n, std::function<void(T*)> deleter);
+
    STRICT_NODISCARD_CONSTEXPR ArrayBase1D(const ArrayBase1D& A);
    STRICT_NODISCARD_CONSTEXPR ArrayBase1D(ArrayBase1D&& A) noexcept;
    STRICT_NODISCARD_CONSTEXPR ArrayBase1D(OneDimBaseType auto const& A);
@@ -95,6 +122,9 @@ public:
    STRICT_CONSTEXPR ArrayBase1D& insert_front(OneDimBaseType auto const& A);
    STRICT_CONSTEXPR ArrayBase1D& insert_back(OneDimBaseType auto const& A);
 
+   // passes ownership of the data to the caller and leaves the array empty
+   STRICT_NODISCARD std::unique_ptr<T[], std::function<void(T*)>> release();
+
    STRICT_NODISCARD_CONSTEXPR_INLINE index_t size() const;
 
    STRICT_NODISCARD_CONSTEXPR_INLINE value_type& index(ImplicitInt i);
@@ -111,13 +141,18 @@ public:
 private:
    value_type* data_;
    index_t n_;
+   // nullptr unless the data was adopted
+   std::function<void(T*)>* deleter_;
+
+   STRICT_CONSTEXPR void deallocate();
 };
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <Builtin T, AlignmentFlag AF>
 STRICT_NODISCARD_CONSTEXPR ArrayBase1D<T, AF>::ArrayBase1D() : data_{nullptr},
-                                                               n_{} {
+                                                               n_{},
+                                                               deleter_{nullptr} {
 }
 
 
@@ -126,7 +161,8 @@ template <Builtin T, AlignmentFlag AF>
 STRICT_NODISCARD ArrayBase1D<T, AF>::ArrayBase1D(ImplicitInt n)
    requires(AF == Aligned)
     : data_{nullptr},
-      n_{n.get()} {
+      n_{n.get()},
+      deleter_{nullptr} {
    ASSERT_STRICT_DEBUG(n_ > -1_sl);
    if(n_ != 0_sl) {
       data_ = new(std::align_val_t{512}) value_type[to_size_t(n_)];
@@ -138,7 +174,8 @@ template <Builtin T, AlignmentFlag AF>
 STRICT_NODISCARD_CONSTEXPR ArrayBase1D<T, AF>::ArrayBase1D(ImplicitInt n)
    requires(AF == Unaligned)
     : data_{nullptr},
-      n_{n.get()} {
+      n_{n.get()},
+      deleter_{nullptr} {
    ASSERT_STRICT_DEBUG(n_ > -1_sl);
    if(n_ != 0_sl) {
       data_ = new value_type[to_size_t(n_)];
@@ -179,6 +216,20 @@ STRICT_NODISCARD_CONSTEXPR ArrayBase1D<T, AF>::ArrayBase1D(L b, L e) : ArrayBase
 }
 
 
+// alignment of adopted data is not checked
+// data is released by deleter if allocation of its copy throws
+template <Builtin T, AlignmentFlag AF>
+STRICT_NODISCARD ArrayBase1D<T, AF>::ArrayBase1D(internal::Adopt, T* data, ImplicitInt n,
+                                                 std::function<void(T*)> deleter)
+    : data_{reinterpret_cast<Strict<T>*>(data)},
+      n_{n.get()},
+      deleter_{internal::adopt_deleter(data, deleter)} {
+   ASSERT_STRICT_DEBUG(n_ > -1_sl);
+   ASSERT_STRICT_DEBUG(*deleter_);
+   ASSERT_STRICT_DEBUG(n_ == 0_sl || data != nullptr);
+}
+
+
 template <Builtin T, AlignmentFlag AF>
 STRICT_NODISCARD_CONSTEXPR ArrayBase1D<T, AF>::ArrayBase1D(const ArrayBase1D<T, AF>& A)
     : ArrayBase1D(A.size()) {
@@ -189,7 +240,8 @@ STRICT_NODISCARD_CONSTEXPR ArrayBase1D<T, AF>::ArrayBase1D(const ArrayBase1D<T,
 template <Builtin T, AlignmentFlag AF>
 STRICT_NODISCARD_CONSTEXPR ArrayBase1D<T, AF>::ArrayBase1D(ArrayBase1D<T, AF>&& A) noexcept
     : data_{std::exchange(A.data_, nullptr)},
-      n_{std::exchange(A.n_, 0_sl)} {
+      n_{std::exchange(A.n_, 0_sl)},
+      deleter_{std::exchange(A.deleter_, nullptr)} {
 }
 
 
@@ -250,7 +302,7 @@ template <Builtin T, AlignmentFlag AF>
 ArrayBase1D<T, AF>::~ArrayBase1D()
    requires(AF == Aligned)
 {
-   operator delete[](data_, std::align_val_t{512});
+   this->deallocate();
 }
 
 
@@ -258,7 +310,21 @@ template <Builtin T, AlignmentFlag AF>
 STRICT_CONSTEXPR ArrayBase1D<T, AF>::~ArrayBase1D()
    requires(AF == Unaligned)
 {
-   delete[] data_;
+   this->deallocate();
+}
+
+
+// adopted data never exists at compile time, so the first branch is not evaluated in constant expressions
+template <Builtin T, AlignmentFlag AF>
+STRICT_CONSTEXPR void ArrayBase1D<T, AF>::deallocate() {
+   if(deleter_ != nullptr) {
+      (*deleter_)(reinterpret_cast<T*>(data_));
+      delete deleter_;
+   } else if constexpr(AF == Aligned) {
+      operator delete[](data_, std::align_val_t{512});
+   } else {
+      delete[] data_;
+   }
 }
 
 
@@ -267,6 +333,7 @@ template <Builtin T, AlignmentFlag AF>
 STRICT_CONSTEXPR void ArrayBase1D<T, AF>::swap(ArrayBase1D& A) noexcept {
    std::swap(data_, A.data_);
    std::swap(n_, A.n_);
+   std::swap(deleter_, A.deleter_);
 }
 
 
@@ -468,6 +535,24 @@ STRICT_CONSTEXPR ArrayBase1D<T, AF>& ArrayBase1D<T, AF>::insert_back(OneDimBaseT
 
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// data that was not adopted is released in the same way as in the destructor
+template <Builtin T, AlignmentFlag AF>
+STRICT_NODISCARD auto ArrayBase1D<T, AF>::release() -> std::unique_ptr<T[], std::function<void(T*)>> {
+   std::function<void(T*)> deleter;
+   if(deleter_ != nullptr) {
+      deleter = std::move(*deleter_);
+      delete std::exchange(deleter_, nullptr);
+   } else if constexpr(AF == Aligned) {
+      deleter = [](T* p) { operator delete[](reinterpret_cast<Strict<T>*>(p), std::align_val_t{512}); };
+   } else {
+      deleter = [](T* p) { delete[] reinterpret_cast<Strict<T>*>(p); };
+   }
+
+   n_ = 0_sl;
+   return {reinterpret_cast<T*>(std::exchange(data_, nullptr)), std::move(deleter)};
+}
+
+
 template <Builtin T, AlignmentFlag AF>
 STRICT_NODISCARD_CONSTEXPR_INLINE index_t ArrayBase1D<T, AF>::size() const {
    return n_;
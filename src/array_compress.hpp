@@ -0,0 +1,482 @@
+//  Copyright (C) 2024 Arkadijs Slobodkins - All Rights Reserved
+// License is 3-clause BSD:
+// https://github.com/arkslobodkins/strict-lib
+
+
+#pragma once
+
+
+#include <algorithm>    // all_of
+#include <bit>          // endian
+#include <cstdint>      // uint8_t, uint64_t
+#include <cstring>      // memcpy
+#include <fstream>      // ifstream, ofstream
+#include <iterator>     // istreambuf_iterator
+#include <limits>       // numeric_limits
+#include <string>       // string
+#include <type_traits>  // make_unsigned_t
+#include <utility>      // as_const
+#include <vector>       // vector
+
+#include "Common/common.hpp"
+#include "derived1D.hpp"
+
+
+// Lossless binary format for one-dimensional arrays. Elements are split into chunks that are
+// compressed independently (and in parallel) in three stages:
+// 1. prediction: every element is replaced by its XOR with, or difference from, the previous one
+// 2. byte shuffle: byte k of all elements of a chunk is stored contiguously
+// 3. LZ77-style compression of the resulting byte stream
+// Smooth floating-point data turns into long runs of equal bytes after the first two stages,
+// which the last stage compresses well.
+namespace slib {
+
+
+enum PredictorFlag { PredictAuto, PredictNone, PredictXor, PredictDelta };
+
+
+// chunk_size is the number of elements per chunk
+// A is allowed to be empty
+std::vector<unsigned char> compress(OneDimBaseType auto const& A, PredictorFlag pf = PredictAuto,
+                                    ImplicitInt chunk_size = 1L << 16);
+
+
+template <Builtin T, AlignmentFlag AF>
+void decompress(const std::vector<unsigned char>& bytes, Array1D<T, AF>& A);
+
+
+// decompresses one chunk at a time and calls f(start, chunk), where start is the
+// position of the first element of chunk in the original array
+template <Builtin T, typename F>
+void decompress_chunks(const std::vector<unsigned char>& bytes, F f);
+
+
+void write_compressed(const std::string& file_path, OneDimBaseType auto const& A,
+                      PredictorFlag pf = PredictAuto, ImplicitInt chunk_size = 1L << 16);
+
+
+template <Builtin T, AlignmentFlag AF>
+void read_compressed(const std::string& file_path, Array1D<T, AF>& A);
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace internal {
+
+
+static constexpr inline unsigned char compress_magic[4] = {'S', 'L', 'Z', '1'};
+static constexpr inline std::size_t compress_header_size = 4 + 4 + 3 * 8;
+static constexpr inline std::size_t lz_min_match = 4;
+static constexpr inline std::size_t lz_max_offset = 65535;
+static constexpr inline int lz_hash_log = 14;
+// bound of decompressed bytes per compressed byte, reached by lengths made of bytes 255
+static constexpr inline std::size_t lz_max_ratio = 255;
+
+
+template <Builtin T>
+STRICT_CONSTEXPR PredictorFlag resolve_predictor(PredictorFlag pf) {
+   if(pf == PredictAuto) {
+      return Integer<T> ? PredictDelta : PredictXor;
+   }
+   // differences are only meaningful for integers
+   if(pf == PredictDelta && !Integer<T>) {
+      return PredictXor;
+   }
+   return pf;
+}
+
+
+STRICT_INLINE void put_u64(std::vector<unsigned char>& out, std::uint64_t x) {
+   for(int k = 0; k < 8; ++k) {
+      out.push_back(static_cast<unsigned char>(x >> (8 * k)));
+   }
+}
+
+
+STRICT_INLINE std::uint64_t get_u64(const unsigned char* p) {
+   std::uint64_t x = 0;
+   for(int k = 0; k < 8; ++k) {
+      x |= std::uint64_t{p[k]} << (8 * k);
+   }
+   return x;
+}
+
+
+STRICT_INLINE std::uint32_t load_u32(const unsigned char* p) {
+   std::uint32_t x;
+   std::memcpy(&x, p, 4);
+   return x;
+}
+
+
+// stages 1 and 2: predicts elements of x and stores their bytes in shuffled order
+template <Builtin T>
+void predict_shuffle(const T* x, std::size_t n, PredictorFlag pf, unsigned char* out) {
+   constexpr std::size_t s = sizeof(T);
+   std::vector<unsigned char> pred(n * s);
+
+   if constexpr(Integer<T>) {
+      if(pf == PredictDelta) {
+         using U = std::make_unsigned_t<T>;
+         U prev = 0;
+         for(std::size_t i = 0; i < n; ++i) {
+            auto cur = static_cast<U>(x[i]);
+            U d = cur - prev;
+            std::memcpy(pred.data() + i * s, &d, s);
+            prev = cur;
+         }
+      }
+   }
+
+   if(pf != PredictDelta) {
+      std::memcpy(pred.data(), x, n * s);
+      if(pf == PredictXor) {
+         for(std::size_t i = n * s; i-- > s;) {
+            pred[i] ^= pred[i - s];
+         }
+      }
+   }
+
+   for(std::size_t k = 0; k < s; ++k) {
+      for(std::size_t i = 0; i < n; ++i) {
+         out[k * n + i] = pred[i * s + k];
+      }
+   }
+}
+
+
+// inverse of predict_shuffle
+template <Builtin T>
+void unshuffle_unpredict(const unsigned char* in, std::size_t n, PredictorFlag pf, T* x) {
+   constexpr std::size_t s = sizeof(T);
+   auto* bytes = reinterpret_cast<unsigned char*>(x);
+   for(std::size_t k = 0; k < s; ++k) {
+      for(std::size_t i = 0; i < n; ++i) {
+         bytes[i * s + k] = in[k * n + i];
+      }
+   }
+
+   if constexpr(Integer<T>) {
+      if(pf == PredictDelta) {
+         using U = std::make_unsigned_t<T>;
+         U prev = 0;
+         for(std::size_t i = 0; i < n; ++i) {
+            U d;
+            std::memcpy(&d, bytes + i * s, s);
+            prev += d;
+            x[i] = static_cast<T>(prev);
+         }
+      }
+   }
+
+   if(pf == PredictXor) {
+      for(std::size_t i = s; i < n * s; ++i) {
+         bytes[i] ^= bytes[i - s];
+      }
+   }
+}
+
+
+STRICT_INLINE void lz_put_length(std::vector<unsigned char>& dst, std::size_t len) {
+   for(; len >= 255; len -= 255) {
+      dst.push_back(255);
+   }
+   dst.push_back(static_cast<unsigned char>(len));
+}
+
+
+// each sequence is a token, literals, and an optional match(offset and length);
+// high and low halves of the token store short literal and match lengths
+STRICT_INLINE void lz_put_sequence(std::vector<unsigned char>& dst, const unsigned char* lit, std::size_t nlit,
+                                   std::size_t offset, std::size_t match) {
+   std::size_t ml = match != 0 ? match - lz_min_match : 0;
+   dst.push_back(static_cast<unsigned char>(((nlit < 15 ? nlit : 15) << 4) | (ml < 15 ? ml : 15)));
+   if(nlit >= 15) {
+      lz_put_length(dst, nlit - 15);
+   }
+   dst.insert(dst.end(), lit, lit + nlit);
+
+   if(match != 0) {
+      dst.push_back(static_cast<unsigned char>(offset));
+      dst.push_back(static_cast<unsigned char>(offset >> 8));
+      if(ml >= 15) {
+         lz_put_length(dst, ml - 15);
+      }
+   }
+}
+
+
+STRICT_INLINE void lz_compress(const unsigned char* src, std::size_t n, std::vector<unsigned char>& dst) {
+   constexpr auto npos = static_cast<std::size_t>(-1);
+   std::vector<std::size_t> table(std::size_t{1} << lz_hash_log, npos);
+
+   std::size_t anchor = 0, ip = 0;
+   while(ip + lz_min_match <= n) {
+      auto v = load_u32(src + ip);
+      auto h = (v * 2654435761u) >> (32 - lz_hash_log);
+      auto ref = table[h];
+      table[h] = ip;
+
+      if(ref != npos && ip - ref <= lz_max_offset && load_u32(src + ref) == v) {
+         auto len = lz_min_match;
+         while(ip + len < n && src[ref + len] == src[ip + len]) {
+            ++len;
+         }
+         lz_put_sequence(dst, src + anchor, ip - anchor, ip - ref, len);
+         ip += len;
+         anchor = ip;
+      } else {
+         ++ip;
+      }
+   }
+   lz_put_sequence(dst, src + anchor, n - anchor, 0, 0);
+}
+
+
+STRICT_INLINE bool lz_get_length(const unsigned char* src, std::size_t n, std::size_t& ip, std::size_t& len) {
+   unsigned char b;
+   do {
+      if(ip >= n) {
+         return false;
+      }
+      b = src[ip++];
+      len += b;
+   } while(b == 255);
+   return true;
+}
+
+
+// returns false if data is corrupted
+STRICT_INLINE bool lz_decompress(const unsigned char* src, std::size_t n, unsigned char* dst, std::size_t m) {
+   std::size_t ip = 0, op = 0;
+   while(ip < n) {
+      unsigned char token = src[ip++];
+
+      std::size_t nlit = token >> 4;
+      if(nlit == 15 && !lz_get_length(src, n, ip, nlit)) {
+         return false;
+      }
+      if(nlit > n - ip || nlit > m - op) {
+         return false;
+      }
+      std::memcpy(dst + op, src + ip, nlit);
+      ip += nlit;
+      op += nlit;
+
+      // last sequence does not contain a match
+      if(ip == n) {
+         break;
+      }
+
+      if(n - ip < 2) {
+         return false;
+      }
+      std::size_t offset = std::size_t{src[ip]} | (std::size_t{src[ip + 1]} << 8);
+      ip += 2;
+
+      std::size_t match = token & 15;
+      if(match == 15 && !lz_get_length(src, n, ip, match)) {
+         return false;
+      }
+      match += lz_min_match;
+      if(offset == 0 || offset > op || match > m - op) {
+         return false;
+      }
+
+      // byte by byte since source and destination may overlap
+      for(std::size_t k = 0; k < match; ++k, ++op) {
+         dst[op] = dst[op - offset];
+      }
+   }
+   return op == m;
+}
+
+
+// a chunk starts with 0 if stored uncompressed and 1 otherwise
+template <Builtin T>
+std::vector<unsigned char> compress_chunk(const T* x, std::size_t n, PredictorFlag pf) {
+   std::vector<unsigned char> shuffled(n * sizeof(T));
+   predict_shuffle(x, n, pf, shuffled.data());
+
+   std::vector<unsigned char> out{1};
+   lz_compress(shuffled.data(), shuffled.size(), out);
+   if(out.size() > shuffled.size()) {
+      out.assign(1, 0);
+      out.insert(out.end(), shuffled.begin(), shuffled.end());
+   }
+   return out;
+}
+
+
+template <Builtin T>
+bool decompress_chunk(const unsigned char* src, std::size_t n, PredictorFlag pf, T* x, std::size_t m) {
+   if(n == 0) {
+      return false;
+   }
+
+   std::vector<unsigned char> shuffled(m * sizeof(T));
+   if(src[0] == 0) {
+      if(n - 1 != shuffled.size()) {
+         return false;
+      }
+      std::memcpy(shuffled.data(), src + 1, n - 1);
+   } else if(src[0] != 1 || !lz_decompress(src + 1, n - 1, shuffled.data(), shuffled.size())) {
+      return false;
+   }
+
+   unshuffle_unpredict(shuffled.data(), m, pf, x);
+   return true;
+}
+
+
+struct CompressedLayout {
+   PredictorFlag pf;
+   long int n;
+   long int chunk_size;
+   long int nchunks;
+   std::vector<std::size_t> offsets;  // nchunks + 1 offsets of chunks in the byte stream
+};
+
+
+template <Builtin T>
+CompressedLayout compressed_layout(const std::vector<unsigned char>& bytes) {
+   constexpr auto* invalid = "invalid compressed data\n";
+   ASSERT_STRICT_ALWAYS_MSG(bytes.size() >= compress_header_size, invalid);
+   ASSERT_STRICT_ALWAYS_MSG(std::memcmp(bytes.data(), compress_magic, 4) == 0, invalid);
+   ASSERT_STRICT_ALWAYS_MSG(bytes[4] == type_code<T>() && bytes[5] == sizeof(T),
+                            "compressed data has a different element type\n");
+   ASSERT_STRICT_ALWAYS_MSG(bytes[7] == (std::endian::native == std::endian::little),
+                            "compressed data has a different byte order\n");
+
+   // only resolved predictors are stored
+   const auto pf = static_cast<PredictorFlag>(bytes[6]);
+   ASSERT_STRICT_ALWAYS_MSG(bytes[6] <= PredictDelta && pf != PredictAuto && resolve_predictor<T>(pf) == pf,
+                            invalid);
+
+   // sizes are checked without overflow before anything is allocated
+   const auto n = get_u64(bytes.data() + 8);
+   const auto chunk_size = get_u64(bytes.data() + 16);
+   const auto nchunks = get_u64(bytes.data() + 24);
+   ASSERT_STRICT_ALWAYS_MSG(n <= std::uint64_t(std::numeric_limits<long int>::max()) / sizeof(T), invalid);
+   ASSERT_STRICT_ALWAYS_MSG(n * sizeof(T) <= lz_max_ratio * (bytes.size() - compress_header_size), invalid);
+   ASSERT_STRICT_ALWAYS_MSG(chunk_size > 0 && chunk_size <= std::uint64_t(std::numeric_limits<long int>::max()),
+                            invalid);
+   ASSERT_STRICT_ALWAYS_MSG(nchunks == n / chunk_size + (n % chunk_size != 0), invalid);
+   ASSERT_STRICT_ALWAYS_MSG(nchunks <= (bytes.size() - compress_header_size) / 8, invalid);
+
+   CompressedLayout L;
+   L.pf = pf;
+   L.n = static_cast<long int>(n);
+   L.chunk_size = static_cast<long int>(chunk_size);
+   L.nchunks = static_cast<long int>(nchunks);
+
+   L.offsets.resize(std::size_t(L.nchunks) + 1);
+   L.offsets[0] = compress_header_size + 8 * std::size_t(L.nchunks);
+   for(std::size_t c = 0; c < std::size_t(L.nchunks); ++c) {
+      auto sz = get_u64(bytes.data() + compress_header_size + 8 * c);
+      ASSERT_STRICT_ALWAYS_MSG(sz <= bytes.size() - L.offsets[c], invalid);
+      L.offsets[c + 1] = L.offsets[c] + sz;
+   }
+   return L;
+}
+
+
+}  // namespace internal
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+std::vector<unsigned char> compress(OneDimBaseType auto const& A, PredictorFlag pf, ImplicitInt chunk_size) {
+   using T = BuiltinTypeOf<decltype(A)>;
+   ASSERT_STRICT_DEBUG(chunk_size.get() > 0_sl);
+   pf = internal::resolve_predictor<T>(pf);
+
+   const long int n = A.size().val();
+   const long int cs = chunk_size.get().val();
+   const long int nchunks = internal::chunk_count(n, cs);
+
+   // expressions are evaluated chunk by chunk, so they are never fully materialized
+   std::vector<std::vector<unsigned char>> chunks(static_cast<std::size_t>(nchunks));
+   internal::parallel_for_range(n, cs, [&](long int first, long int last) {
+      std::vector<T> x(static_cast<std::size_t>(last - first));
+      for(long int i = first; i < last; ++i) {
+         x[std::size_t(i - first)] = A.index(i).val();
+      }
+      chunks[std::size_t(first / cs)] = internal::compress_chunk(x.data(), x.size(), pf);
+   });
+
+   std::vector<unsigned char> bytes(internal::compress_magic, internal::compress_magic + 4);
+   bytes.push_back(internal::type_code<T>());
+   bytes.push_back(sizeof(T));
+   bytes.push_back(static_cast<unsigned char>(pf));
+   bytes.push_back(std::endian::native == std::endian::little);
+   internal::put_u64(bytes, std::uint64_t(n));
+   internal::put_u64(bytes, std::uint64_t(cs));
+   internal::put_u64(bytes, std::uint64_t(nchunks));
+   for(const auto& chunk : chunks) {
+      internal::put_u64(bytes, chunk.size());
+   }
+   for(const auto& chunk : chunks) {
+      bytes.insert(bytes.end(), chunk.begin(), chunk.end());
+   }
+   return bytes;
+}
+
+
+template <Builtin T, AlignmentFlag AF>
+void decompress(const std::vector<unsigned char>& bytes, Array1D<T, AF>& A) {
+   auto L = internal::compressed_layout<T>(bytes);
+   Array1D<T, AF> tmp(L.n);
+   T* x = tmp.blas_data();
+
+   std::vector<char> valid(static_cast<std::size_t>(L.nchunks), 0);
+   internal::parallel_for(L.nchunks, [&](long int c) {
+      auto uc = std::size_t(c);
+      long int first = c * L.chunk_size;
+      long int m = mins(Strict{L.chunk_size}, Strict{L.n - first}).val();
+      valid[uc] = internal::decompress_chunk(bytes.data() + L.offsets[uc], L.offsets[uc + 1] - L.offsets[uc],
+                                             L.pf, x + first, std::size_t(m));
+   });
+   ASSERT_STRICT_ALWAYS_MSG(std::ranges::all_of(valid, [](char v) { return v != 0; }),
+                            "invalid compressed data\n");
+
+   A.swap(tmp);
+}
+
+
+template <Builtin T, typename F>
+void decompress_chunks(const std::vector<unsigned char>& bytes, F f) {
+   auto L = internal::compressed_layout<T>(bytes);
+   Array1D<T> chunk;
+
+   for(long int c = 0; c < L.nchunks; ++c) {
+      auto uc = std::size_t(c);
+      long int first = c * L.chunk_size;
+      chunk.resize_forget(mins(Strict{L.chunk_size}, Strict{L.n - first}));
+      bool valid = internal::decompress_chunk(bytes.data() + L.offsets[uc], L.offsets[uc + 1] - L.offsets[uc],
+                                              L.pf, chunk.blas_data(), to_size_t(chunk.size()));
+      ASSERT_STRICT_ALWAYS_MSG(valid, "invalid compressed data\n");
+      f(index_t{first}, std::as_const(chunk));
+   }
+}
+
+
+void write_compressed(const std::string& file_path, OneDimBaseType auto const& A, PredictorFlag pf,
+                      ImplicitInt chunk_size) {
+   auto bytes = compress(A, pf, chunk_size);
+   std::ofstream ofs{file_path, std::ios::binary};
+   ASSERT_STRICT_ALWAYS_MSG(ofs, "invalid file path");
+   ofs.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+   ofs.close();
+}
+
+
+template <Builtin T, AlignmentFlag AF>
+void read_compressed(const std::string& file_path, Array1D<T, AF>& A) {
+   std::ifstream ifs{file_path, std::ios::binary};
+   ASSERT_STRICT_ALWAYS_MSG(ifs, "invalid file path");
+   std::vector<unsigned char> bytes{std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+   ifs.close();
+   decompress(bytes, A);
+}
+
+
+}  // namespace slib
@@ -6,16 +6,24 @@
 #pragma once
 
 
-#include <algorithm>  // sort, shuffle
-#include <concepts>   // invocable
-#include <memory>     // unique_ptr, make_unique
-#include <random>     // random_device, mt19937
-#include <tuple>      // tuple
-#include <utility>    // pair, declval, forward
-#include <vector>     // vector
+#include <algorithm>    // min, nth_element, partial_sort, sort
+#include <atomic>       // atomic
+#include <bit>          // bit_cast, countr_one
+#include <cmath>        // ceil
+#include <concepts>     // invocable
+#include <cstdint>      // uint64_t
+#include <limits>       // numeric_limits
+#include <memory>       // unique_ptr, make_unique_for_overwrite
+#include <tuple>        // tuple
+#include <type_traits>  // is_constant_evaluated, is_pointer_v
+#include <utility>      // pair, declval, forward, swap
+#include <vector>       // vector
 
 #include "Common/common.hpp"
+#include "Common/sort.hpp"
 #include "Expr/array_expr1D.hpp"
+#include "Util/random.hpp"
+#include "interop.hpp"
 
 
 // generic functions that work on Arrays, SliceArrays, and their expression templates.
@@ -37,6 +45,11 @@ template <typename Base1, typename Base2, typename F> concept CallableArgs2
    && SameAs<StrictBool, decltype(std::declval<F>()(ValueTypeOf<Base1>{}, ValueTypeOf<Base2>{}))>;
 
 
+// condition of masked reductions: predicate on elements of Base or boolean expression of the same size
+template <typename Base, typename C> concept MaskOrPredicate
+    = OneDimBooleanBaseType<C> || (!OneDimBaseType<C> && CallableArgs1<Base, C>);
+
+
 template <typename Base, typename F> concept SortableArgs
     = std::invocable<F, ValueTypeOf<Base>, ValueTypeOf<Base>>
    && SameAs<StrictBool, decltype(std::declval<F>()(ValueTypeOf<Base>{}, ValueTypeOf<Base>{}))>;
@@ -67,6 +80,8 @@ STRICT_CONSTEXPR auto max(const Base& A);
 // or
 // returns std::tuple<index_t, index_t, Strict<real_type>>
 // depending on the type
+// the first occurrence of the minimum is returned; for one-dimensional types NaNs are skipped,
+// unless all elements are NaN, in which case the first element is returned
 template <RealBaseType Base>
 STRICT_CONSTEXPR auto min_index(const Base& A);
 
@@ -75,6 +90,8 @@ STRICT_CONSTEXPR auto min_index(const Base& A);
 // or
 // returns std::tuple<index_t, index_t, Strict<real_type>>
 // depending on the type
+// the first occurrence of the maximum is returned; for one-dimensional types NaNs are skipped,
+// unless all elements are NaN, in which case the first element is returned
 template <RealBaseType Base>
 STRICT_CONSTEXPR auto max_index(const Base& A);
 
@@ -156,6 +173,8 @@ template <RealBaseType Base>
 STRICT_CONSTEXPR StrictBool all_non_neg(const Base& A);
 
 
+// f is called serially in the order of elements; elements are tested in blocks, so that f is also
+// called on the elements that follow the first hit in its block
 template <BaseType Base, typename F>
    requires CallableArgs1<Base, F>
 STRICT_CONSTEXPR StrictBool none_of(const Base& A, F f);
@@ -186,6 +205,94 @@ template <BaseType Base1, BaseType Base2, typename F>
 STRICT_CONSTEXPR StrictBool all_of(const Base1& A1, const Base2& A2, F f);
 
 
+// Same as above, but large arrays are searched in parallel, and the search is abandoned by all
+// threads once one of them finds a hit. f must be pure, thread-safe, and must not throw, since it is
+// called concurrently and on elements that follow the first hit.
+template <BaseType Base, typename F>
+   requires CallableArgs1<Base, F>
+STRICT_CONSTEXPR StrictBool parallel_none_of(const Base& A, F f);
+
+
+template <BaseType Base, typename F>
+   requires CallableArgs1<Base, F>
+STRICT_CONSTEXPR StrictBool parallel_any_of(const Base& A, F f);
+
+
+template <BaseType Base, typename F>
+   requires CallableArgs1<Base, F>
+STRICT_CONSTEXPR StrictBool parallel_all_of(const Base& A, F f);
+
+
+// A is allowed to be empty
+// reductions of masks, such as A < B or (A > x) && (A < y); any returns false
+// and all returns true if A is empty
+template <OneDimBooleanBaseType Base>
+STRICT_CONSTEXPR index_t count(const Base& A);
+
+
+template <OneDimBooleanBaseType Base>
+STRICT_CONSTEXPR StrictBool any(const Base& A);
+
+
+template <OneDimBooleanBaseType Base>
+STRICT_CONSTEXPR StrictBool all(const Base& A);
+
+
+// reductions of elements of A for which c is true, where c is a predicate or a boolean expression;
+// conditions are evaluated with the reduction in one pass and nothing is allocated.
+// mean_if, min_if, and max_if require that at least one element satisfies c. min_if and max_if
+// skip NaNs, as min_index and max_index do, and give infinities if all such elements are NaN
+template <OneDimRealBaseType Base, typename C>
+   requires MaskOrPredicate<Base, C>
+STRICT_NODISCARD index_t count_if(const Base& A, const C& c);
+
+
+template <OneDimRealBaseType Base, typename C>
+   requires MaskOrPredicate<Base, C>
+STRICT_NODISCARD auto sum_if(const Base& A, const C& c);
+
+
+template <OneDimFloatingBaseType Base, typename C>
+   requires MaskOrPredicate<Base, C>
+STRICT_NODISCARD auto mean_if(const Base& A, const C& c);
+
+
+template <OneDimRealBaseType Base, typename C>
+   requires MaskOrPredicate<Base, C>
+STRICT_NODISCARD auto min_if(const Base& A, const C& c);
+
+
+template <OneDimRealBaseType Base, typename C>
+   requires MaskOrPredicate<Base, C>
+STRICT_NODISCARD auto max_if(const Base& A, const C& c);
+
+
+template <OneDimFloatingBaseType Base, typename C>
+   requires MaskOrPredicate<Base, C>
+STRICT_NODISCARD auto norm2_if(const Base& A, const C& c);
+
+
+// A is allowed to be empty
+// evaluates A into memory pointed to by out, which must have room for A.size() elements
+// and must not overlap with data referenced by A
+template <BaseType Base>
+STRICT_CONSTEXPR void eval_into(const Base& A, BuiltinTypeOf<Base>* out);
+
+
+// Same as above, but out is resized if its size is different from the size of A,
+// so that repeated evaluation of expressions of the same size does not allocate. If the sizes
+// are equal, A is evaluated in place, so that element i of A must not refer to other elements of out
+template <OneDimBaseType Base, AlignmentFlag AF>
+STRICT_CONSTEXPR void eval_into(const Base& A, Array1D<BuiltinTypeOf<Base>, AF>& out);
+
+
+// Same as above, but out is a slice or attached array of the same size as A; element i of A
+// must not refer to other elements of out
+template <OneDimBaseType Base, typename Out>
+   requires(OneDimNonConstBaseType<RemoveRef<Out>> && !Array1DType<RemoveRef<Out>>)
+STRICT_CONSTEXPR void eval_into(const Base& A, Out&& out);
+
+
 // A is allowed to be empty
 template <RealBaseType Base>
 STRICT_CONSTEXPR_2023 std::unique_ptr<RealTypeOf<Base>[]> blas_array(const Base& A);
@@ -254,6 +361,13 @@ template <typename Base>
 STRICT_CONSTEXPR void sort_decreasing(Base&& A);
 
 
+// A is allowed to be empty
+template <typename Base>
+   requires(NonConstBaseType<RemoveRef<Base>> && !IsConst<RemoveRef<Base>>
+            && !ArrayOneDimRealTypeRvalue<Base>)
+void shuffle(Base&& A, std::uint64_t seed);
+
+
 // A is allowed to be empty
 template <typename Base>
    requires(NonConstBaseType<RemoveRef<Base>> && !IsConst<RemoveRef<Base>>
@@ -261,6 +375,12 @@ template <typename Base>
 void shuffle(Base&& A);
 
 
+STRICT_NODISCARD_INLINE Array1D<long int> random_permutation(ImplicitInt n, std::uint64_t seed);
+
+
+STRICT_NODISCARD_INLINE Array1D<long int> random_permutation(ImplicitInt n);
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 namespace internal {
 template <RealBaseType Base>
@@ -336,19 +456,190 @@ STRICT_CONSTEXPR auto max(const Base& A) {
 }
 
 
+namespace internal {
+
+
+// identities of min and max, which are infinite for floating point types, so that infinite elements are found
+template <Real T>
+constexpr inline T min_identity
+    = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+
+
+template <Real T>
+constexpr inline T max_identity
+    = std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+
+
+#ifdef STRICT_QUAD_PRECISION
+template <>
+constexpr inline float128 min_identity<float128> = HUGE_VALQ;
+
+
+template <>
+constexpr inline float128 max_identity<float128> = -HUGE_VALQ;
+#endif
+
+
+// elements are tested in blocks of this size; results within a block are combined without branches,
+// so that the loop vectorizes, and the search stops at the end of the first block that contains a hit
+static constexpr inline long int mask_block = 256;
+
+
+template <typename F>
+STRICT_CONSTEXPR bool any_range(long int first, long int last, F f) {
+   for(; first < last; first += mask_block) {
+      const long int end = std::min(last, first + mask_block);
+      int b = 0;  // boolean reductions are not vectorized
+      for(long int i = first; i < end; ++i) {
+         b |= static_cast<int>(f(i));
+      }
+      if(b != 0) {
+         return true;
+      }
+   }
+   return false;
+}
+
+
+// chunks are searched in parallel; once a hit is found, the remaining blocks and chunks are skipped
+template <typename F>
+bool parallel_any(long int n, F f) {
+   std::atomic<bool> found{false};
+   parallel_for_range(n, parallel_threshold, [&](long int first, long int last) {
+      for(long int b = first; b < last; b += mask_block) {
+         if(found.load(std::memory_order_relaxed)) {
+            return;
+         }
+         if(any_range(b, std::min(last, b + mask_block), f)) {
+            found.store(true, std::memory_order_relaxed);
+         }
+      }
+   });
+   return found.load();
+}
+
+
+// true if f(i) is true for some i in [0, n); for large n, f is called concurrently and on
+// elements that follow the first hit, so that it must be pure, thread-safe, and must not throw
+template <typename F>
+STRICT_CONSTEXPR bool any_index(long int n, F f) {
+   if(!std::is_constant_evaluated() && n > parallel_threshold) {
+      return parallel_any(n, f);
+   }
+   return any_range(0, n, f);
+}
+
+
+// first i in [first, last) such that get(i) == x, or last if there is none
+template <typename T, typename Get>
+STRICT_CONSTEXPR long int find_first(long int first, long int last, Get get, T x) {
+   for(; first < last; first += mask_block) {
+      if(any_range(first, std::min(last, first + mask_block), [&](long int i) { return get(i) == x; })) {
+         while(!(get(first) == x)) {
+            ++first;
+         }
+         return first;
+      }
+   }
+   return last;
+}
+
+
+// number of independent lanes of argmin and argmax; the loop over lanes is not unrolled
+// for this size and is vectorized
+static constexpr inline long int arg_lanes = 32;
+
+
+// best of get(first), ..., get(last - 1), where better(x, y) is true if x is strictly better than y
+// and identity is not better than any value; NaNs are skipped
+template <typename T, typename Get, typename Better>
+STRICT_CONSTEXPR T best_value(long int first, long int last, Get get, Better better, T identity) {
+   T v[arg_lanes];
+   std::fill(v, v + arg_lanes, identity);
+   long int i = first;
+   for(; i + arg_lanes <= last; i += arg_lanes) {
+      for(long int j = 0; j < arg_lanes; ++j) {
+         const T x = get(i + j);
+         v[j] = better(x, v[j]) ? x : v[j];
+      }
+   }
+   for(; i < last; ++i) {
+      const T x = get(i);
+      v[0] = better(x, v[0]) ? x : v[0];
+   }
+   T best = v[0];
+   for(long int j = 1; j < arg_lanes; ++j) {
+      best = better(v[j], best) ? v[j] : best;
+   }
+   return best;
+}
+
+
+template <typename T>
+struct ArgBest {
+   T value;
+   long int index;
+};
+
+
+// y replaces x if its value is better, if values are equal and y comes first, or if x is NaN and y is not
+template <typename T, typename Better>
+STRICT_CONSTEXPR_INLINE ArgBest<T> arg_best_combine(ArgBest<T> x, ArgBest<T> y, Better better) {
+   const bool x_nan = x.value != x.value;
+   const bool y_nan = y.value != y.value;
+   const bool b = better(y.value, x.value) || (y.value == x.value && y.index < x.index) || (x_nan && !y_nan)
+               || (x_nan && y_nan && y.index < x.index);
+   return b ? y : x;
+}
+
+
+// First position of the best value in [first, last), found in two vectorized passes: the best value,
+// and the first position where it occurs, which is usually read from cache. NaNs are skipped,
+// unless all values are NaN, in which case first is returned.
+template <typename T, typename Get, typename Better>
+STRICT_CONSTEXPR ArgBest<T> arg_best_range(long int first, long int last, Get get, Better better, T identity) {
+   const T best = best_value(first, last, get, better, identity);
+   if(const long int i = find_first(first, last, get, best); i < last) {
+      // best may be a zero of the other sign than get(i)
+      return {get(i), i};
+   }
+   return {get(first), first};
+}
+
+
+// chunks are searched in parallel and combined in order
+template <typename T, typename Get, typename Better>
+STRICT_CONSTEXPR ArgBest<T> arg_best(long int n, Get get, Better better, T identity) {
+   if(std::is_constant_evaluated() || n <= parallel_threshold) {
+      return arg_best_range(0, n, get, better, identity);
+   }
+   const long int nchunks = chunk_count(n, parallel_threshold);
+   std::vector<ArgBest<T>> part(static_cast<std::size_t>(nchunks));
+   parallel_for_range(n, parallel_threshold, [&](long int first, long int last) {
+      const long int c = first / parallel_threshold;
+      part[static_cast<std::size_t>(c)] = arg_best_range(first, last, get, better, identity);
+   });
+   ArgBest<T> r = part[0];
+   for(std::size_t c = 1; c < part.size(); ++c) {
+      r = arg_best_combine(r, part[c], better);
+   }
+   return r;
+}
+
+
+}  // namespace internal
+
+
 template <RealBaseType Base>
 STRICT_CONSTEXPR auto min_index(const Base& A) {
    ASSERT_STRICT_DEBUG(!A.empty());
    using value_type = ValueTypeOf<Base>;
 
    if constexpr(OneDimBaseType<Base>) {
-      std::pair<index_t, value_type> min = {0_sl, A.index(0)};
-      for(index_t i = 1_sl; i < A.size(); ++i) {
-         if(auto xi = A.index(i); xi < min.second) {
-            min = {i, xi};
-         }
-      }
-      return min;
+      using T = RealTypeOf<Base>;
+      const auto r = internal::arg_best<T>(A.size().val(), [&A](long int i) { return A.index(i).val(); },
+                                           [](T x, T y) { return x < y; }, internal::min_identity<T>);
+      return std::pair<index_t, value_type>{index_t{r.index}, value_type{r.value}};
    } else {
       std::tuple<index_t, index_t, value_type> min = {0_sl, 0_sl, A.index(0, 0)};
       for(index_t i = 0_sl; i < A.rows(); ++i) {
@@ -369,13 +660,10 @@ STRICT_CONSTEXPR auto max_index(const Base& A) {
    using value_type = ValueTypeOf<Base>;
 
    if constexpr(OneDimBaseType<Base>) {
-      std::pair<index_t, value_type> max = {0_sl, A.index(0)};
-      for(index_t i = 1_sl; i < A.size(); ++i) {
-         if(auto xi = A.index(i); xi > max.second) {
-            max = {i, xi};
-         }
-      }
-      return max;
+      using T = RealTypeOf<Base>;
+      const auto r = internal::arg_best<T>(A.size().val(), [&A](long int i) { return A.index(i).val(); },
+                                           [](T x, T y) { return x > y; }, internal::max_identity<T>);
+      return std::pair<index_t, value_type>{index_t{r.index}, value_type{r.value}};
    } else {
       std::tuple<index_t, index_t, value_type> max = {0_sl, 0_sl, A.index(0, 0)};
       for(index_t i = 0_sl; i < A.rows(); ++i) {
@@ -390,24 +678,68 @@ STRICT_CONSTEXPR auto max_index(const Base& A) {
 }
 
 
+namespace internal {
+
+
+// Floating point numbers whose bits can be classified as integers. Bits of |x| are greater than
+// bits of infinity for NaNs, equal for infinities, and smaller for finite numbers. Integer
+// comparisons vectorize and are not removed by -ffinite-math-only.
+template <typename T> concept BitClassifiable = SameAs<T, float> || SameAs<T, double>;
+
+
+template <BitClassifiable T>
+STRICT_CONSTEXPR_INLINE RadixKey<T> abs_bits(T x) {
+   using K = RadixKey<T>;
+   return std::bit_cast<K>(x) & ~(K{1} << (8 * sizeof(T) - 1));
+}
+
+
+template <BitClassifiable T>
+constexpr inline RadixKey<T> inf_bits = std::bit_cast<RadixKey<T>>(std::numeric_limits<T>::infinity());
+
+
+}  // namespace internal
+
+
 template <FloatingBaseType Base>
 STRICT_CONSTEXPR_2023 StrictBool all_finite(const Base& A) {
    ASSERT_STRICT_DEBUG(!A.empty());
-   return all_of(A, [](auto x) { return isfinites(x); });
+   using T = RealTypeOf<Base>;
+   if constexpr(internal::BitClassifiable<T>) {
+      return StrictBool{!internal::any_index(A.size().val(), [&A](long int i) {
+         return internal::abs_bits(A.index(i).val()) >= internal::inf_bits<T>;
+      })};
+   } else {
+      return parallel_all_of(A, [](auto x) { return parallel_isfinites(x); });
+   }
 }
 
 
 template <FloatingBaseType Base>
 STRICT_CONSTEXPR_2023 StrictBool has_inf(const Base& A) {
    ASSERT_STRICT_DEBUG(!A.empty());
-   return any_of(A, [](auto x) { return isinfs(x); });
+   using T = RealTypeOf<Base>;
+   if constexpr(internal::BitClassifiable<T>) {
+      return StrictBool{internal::any_index(A.size().val(), [&A](long int i) {
+         return internal::abs_bits(A.index(i).val()) == internal::inf_bits<T>;
+      })};
+   } else {
+      return parallel_any_of(A, [](auto x) { return parallel_isinfs(x); });
+   }
 }
 
 
 template <FloatingBaseType Base>
 STRICT_CONSTEXPR_2023 StrictBool has_nan(const Base& A) {
    ASSERT_STRICT_DEBUG(!A.empty());
-   return any_of(A, [](auto x) { return isnans(x); });
+   using T = RealTypeOf<Base>;
+   if constexpr(internal::BitClassifiable<T>) {
+      return StrictBool{internal::any_index(A.size().val(), [&A](long int i) {
+         return internal::abs_bits(A.index(i).val()) > internal::inf_bits<T>;
+      })};
+   } else {
+      return parallel_any_of(A, [](auto x) { return parallel_isnans(x); });
+   }
 }
 
 
@@ -510,7 +842,7 @@ template <RealBaseType Base>
 STRICT_CONSTEXPR StrictBool has_zero(const Base& A) {
    ASSERT_STRICT_DEBUG(!A.empty());
    auto is_zero = []<Real T>(const Strict<T>& x) { return x == Zero<T>; };
-   return any_of(A, is_zero);
+   return parallel_any_of(A, is_zero);
 }
 
 
@@ -518,7 +850,7 @@ template <RealBaseType Base>
 STRICT_CONSTEXPR StrictBool all_pos(const Base& A) {
    ASSERT_STRICT_DEBUG(!A.empty());
    auto is_positive = []<Real T>(const Strict<T>& x) { return x > Zero<T>; };
-   return all_of(A, is_positive);
+   return parallel_all_of(A, is_positive);
 }
 
 
@@ -526,7 +858,7 @@ template <RealBaseType Base>
 STRICT_CONSTEXPR StrictBool all_neg(const Base& A) {
    ASSERT_STRICT_DEBUG(!A.empty());
    auto is_negative = []<Real T>(const Strict<T>& x) { return x < Zero<T>; };
-   return all_of(A, is_negative);
+   return parallel_all_of(A, is_negative);
 }
 
 
@@ -534,7 +866,7 @@ template <RealBaseType Base>
 STRICT_CONSTEXPR StrictBool all_non_pos(const Base& A) {
    ASSERT_STRICT_DEBUG(!A.empty());
    auto is_non_positive = []<Real T>(const Strict<T>& x) { return x <= Zero<T>; };
-   return all_of(A, is_non_positive);
+   return parallel_all_of(A, is_non_positive);
 }
 
 
@@ -542,7 +874,7 @@ template <RealBaseType Base>
 STRICT_CONSTEXPR StrictBool all_non_neg(const Base& A) {
    ASSERT_STRICT_DEBUG(!A.empty());
    auto is_non_negative = []<Real T>(const Strict<T>& x) { return x >= Zero<T>; };
-   return all_of(A, is_non_negative);
+   return parallel_all_of(A, is_non_negative);
 }
 
 
@@ -567,12 +899,7 @@ template <BaseType Base, typename F>
    requires CallableArgs1<Base, F>
 STRICT_CONSTEXPR StrictBool any_of(const Base& A, F f) {
    ASSERT_STRICT_DEBUG(!A.empty());
-   for(index_t i = 0_sl; i < A.size(); ++i) {
-      if(f(A.index(i))) {
-         return true_sb;
-      }
-   }
-   return false_sb;
+   return StrictBool{internal::any_range(0, A.size().val(), [&A, &f](long int i) { return f(A.index(i)).val(); })};
 }
 
 
@@ -581,12 +908,8 @@ template <BaseType Base1, BaseType Base2, typename F>
 STRICT_CONSTEXPR StrictBool any_of(const Base1& A1, const Base2& A2, F f) {
    ASSERT_STRICT_DEBUG(!A1.empty());
    ASSERT_STRICT_DEBUG(same_size(A1, A2));
-   for(index_t i = 0_sl; i < A1.size(); ++i) {
-      if(f(A1.index(i), A2.index(i))) {
-         return true_sb;
-      }
-   }
-   return false_sb;
+   return StrictBool{internal::any_range(0, A1.size().val(),
+                                         [&A1, &A2, &f](long int i) { return f(A1.index(i), A2.index(i)).val(); })};
 }
 
 
@@ -594,12 +917,7 @@ template <BaseType Base, typename F>
    requires CallableArgs1<Base, F>
 STRICT_CONSTEXPR StrictBool all_of(const Base& A, F f) {
    ASSERT_STRICT_DEBUG(!A.empty());
-   for(index_t i = 0_sl; i < A.size(); ++i) {
-      if(!f(A.index(i))) {
-         return false_sb;
-      }
-   }
-   return true_sb;
+   return StrictBool{!internal::any_range(0, A.size().val(), [&A, &f](long int i) { return !f(A.index(i)).val(); })};
 }
 
 
@@ -608,114 +926,1343 @@ template <BaseType Base1, BaseType Base2, typename F>
 STRICT_CONSTEXPR StrictBool all_of(const Base1& A1, const Base2& A2, F f) {
    ASSERT_STRICT_DEBUG(!A1.empty());
    ASSERT_STRICT_DEBUG(same_size(A1, A2));
-   for(index_t i = 0_sl; i < A1.size(); ++i) {
-      if(!f(A1.index(i), A2.index(i))) {
-         return false_sb;
+   return StrictBool{!internal::any_range(0, A1.size().val(),
+                                          [&A1, &A2, &f](long int i) { return !f(A1.index(i), A2.index(i)).val(); })};
+}
+
+
+template <BaseType Base, typename F>
+   requires CallableArgs1<Base, F>
+STRICT_CONSTEXPR StrictBool parallel_none_of(const Base& A, F f) {
+   ASSERT_STRICT_DEBUG(!A.empty());
+   return !parallel_any_of(A, f);
+}
+
+
+template <BaseType Base, typename F>
+   requires CallableArgs1<Base, F>
+STRICT_CONSTEXPR StrictBool parallel_any_of(const Base& A, F f) {
+   ASSERT_STRICT_DEBUG(!A.empty());
+   return StrictBool{internal::any_index(A.size().val(), [&A, &f](long int i) { return f(A.index(i)).val(); })};
+}
+
+
+template <BaseType Base, typename F>
+   requires CallableArgs1<Base, F>
+STRICT_CONSTEXPR StrictBool parallel_all_of(const Base& A, F f) {
+   ASSERT_STRICT_DEBUG(!A.empty());
+   return StrictBool{!internal::any_index(A.size().val(), [&A, &f](long int i) { return !f(A.index(i)).val(); })};
+}
+
+
+namespace internal {
+
+
+template <OneDimBooleanBaseType Base>
+STRICT_CONSTEXPR long int count_range(const Base& A, long int first, long int last) {
+   long int k = 0;
+   for(long int i = first; i < last; ++i) {
+      k += static_cast<long int>(A.index(i).val());
+   }
+   return k;
+}
+
+
+}  // namespace internal
+
+
+template <OneDimBooleanBaseType Base>
+STRICT_CONSTEXPR index_t count(const Base& A) {
+   using namespace internal;
+   const long int n = A.size().val();
+   if(std::is_constant_evaluated() || n <= parallel_threshold) {
+      return index_t{count_range(A, 0, n)};
+   }
+
+   const long int nchunks = chunk_count(n, parallel_threshold);
+   std::vector<long int> k(static_cast<std::size_t>(nchunks));
+   parallel_for_range(n, parallel_threshold, [&](long int first, long int last) {
+      const long int c = first / parallel_threshold;
+      k[static_cast<std::size_t>(c)] = count_range(A, first, last);
+   });
+   long int total = 0;
+   for(auto x : k) {
+      total += x;
+   }
+   return index_t{total};
+}
+
+
+template <OneDimBooleanBaseType Base>
+STRICT_CONSTEXPR StrictBool any(const Base& A) {
+   return StrictBool{internal::any_index(A.size().val(), [&A](long int i) { return A.index(i).val(); })};
+}
+
+
+template <OneDimBooleanBaseType Base>
+STRICT_CONSTEXPR StrictBool all(const Base& A) {
+   return StrictBool{!internal::any_index(A.size().val(), [&A](long int i) { return !A.index(i).val(); })};
+}
+
+
+namespace internal {
+
+
+// number of independent accumulators of masked reductions, so that loops
+// vectorize without reassociation of floating point operations
+static constexpr inline long int reduce_lanes = 8;
+
+
+// reduction by op of get(i) for i in [first, last) such that keep(i) is true. get(i) is evaluated
+// for all i and elements that are not kept are replaced by identity without branches.
+template <typename T, typename Get, typename Keep, typename Op>
+T masked_reduce_range(long int first, long int last, Get get, Keep keep, T identity, Op op) {
+   T acc[reduce_lanes];
+   std::fill(acc, acc + reduce_lanes, identity);
+   long int i = first;
+   for(; i + reduce_lanes <= last; i += reduce_lanes) {
+      for(long int j = 0; j < reduce_lanes; ++j) {
+         const T x = get(i + j);
+         acc[j] = op(acc[j], keep(i + j) ? x : identity);
       }
    }
-   return true_sb;
+   for(; i < last; ++i) {
+      const T x = get(i);
+      acc[0] = op(acc[0], keep(i) ? x : identity);
+   }
+   T r = identity;
+   for(auto x : acc) {
+      r = op(r, x);
+   }
+   return r;
 }
 
 
-template <RealBaseType Base>
-STRICT_CONSTEXPR_2023 std::unique_ptr<RealTypeOf<Base>[]> blas_array(const Base& A) {
-   if(A.empty()) {
-      return nullptr;
+// chunks are reduced in parallel and combined in order, so that
+// the result does not depend on the number of threads
+template <typename T, typename Get, typename Keep, typename Op>
+T masked_reduce(long int n, Get get, Keep keep, T identity, Op op) {
+   if(n <= parallel_threshold) {
+      return masked_reduce_range(0, n, get, keep, identity, op);
    }
+   const long int nchunks = chunk_count(n, parallel_threshold);
+   std::vector<T> part(static_cast<std::size_t>(nchunks));
+   parallel_for_range(n, parallel_threshold, [&](long int first, long int last) {
+      const long int c = first / parallel_threshold;
+      part[static_cast<std::size_t>(c)] = masked_reduce_range(first, last, get, keep, identity, op);
+   });
+   T r = identity;
+   for(auto x : part) {
+      r = op(r, x);
+   }
+   return r;
+}
 
-   using real_type = RealTypeOf<Base>;
-   auto blas_array = std::make_unique<real_type[]>(to_size_t(A.size()));
-   auto* ptr = blas_array.get();
-   for(index_t i = 0_sl; i < A.size(); ++i) {
-      ptr[i.val()] = A.index(i).val();
+
+// keep(i) of masked_reduce
+template <typename Base, typename C>
+auto mask_keep(const Base& A, const C& c) {
+   if constexpr(OneDimBooleanBaseType<C>) {
+      ASSERT_STRICT_DEBUG(same_size(A, c));
+      return [&c](long int i) { return c.index(i).val(); };
+   } else {
+      return [&A, &c](long int i) { return bool{c(A.index(i))}; };
    }
-   return blas_array;
 }
 
 
 template <typename Base>
-   requires(OneDimRealBaseType<RemoveRef<Base>> && !ArrayOneDimRealTypeRvalue<Base>)
-STRICT_CONSTEXPR auto in_open_range(Base&& A, ValueTypeOf<Base> low, ValueTypeOf<Base> high) {
-   ASSERT_STRICT_DEBUG(low <= high);
-   return in_cond_range(std::forward<Base>(A), [low, high](auto x) { return x > low && x < high; });
+auto element_get(const Base& A) {
+   return [&A](long int i) { return A.index(i).val(); };
 }
 
 
-// Same as above
-template <typename Base>
-   requires(OneDimRealBaseType<RemoveRef<Base>> && !ArrayOneDimRealTypeRvalue<Base>)
-STRICT_CONSTEXPR auto in_open_range(Base&& A, Low<RealTypeOf<Base>> low, High<RealTypeOf<Base>> high) {
-   return in_open_range(std::forward<Base>(A), low.get(), high.get());
+}  // namespace internal
+
+
+template <OneDimRealBaseType Base, typename C>
+   requires MaskOrPredicate<Base, C>
+STRICT_NODISCARD index_t count_if(const Base& A, const C& c) {
+   return index_t{internal::masked_reduce(
+       A.size().val(), [](long int) { return 1L; }, internal::mask_keep(A, c), 0L,
+       [](long int x, long int y) { return x + y; })};
 }
 
 
-template <typename Base>
-   requires(OneDimRealBaseType<RemoveRef<Base>> && !ArrayOneDimRealTypeRvalue<Base>)
-STRICT_CONSTEXPR auto in_closed_range(Base&& A, ValueTypeOf<Base> low, ValueTypeOf<Base> high) {
-   ASSERT_STRICT_DEBUG(low <= high);
-   return in_cond_range(std::forward<Base>(A), [low, high](auto x) { return x >= low && x <= high; });
+template <OneDimRealBaseType Base, typename C>
+   requires MaskOrPredicate<Base, C>
+STRICT_NODISCARD auto sum_if(const Base& A, const C& c) {
+   using T = RealTypeOf<Base>;
+   return Strict{internal::masked_reduce(A.size().val(), internal::element_get(A), internal::mask_keep(A, c), T(0),
+                                         [](T x, T y) { return static_cast<T>(x + y); })};
 }
 
 
-template <typename Base>
-   requires(OneDimRealBaseType<RemoveRef<Base>> && !ArrayOneDimRealTypeRvalue<Base>)
-STRICT_CONSTEXPR auto in_closed_range(Base&& A, Low<RealTypeOf<Base>> low, High<RealTypeOf<Base>> high) {
-   return in_closed_range(std::forward<Base>(A), low.get(), high.get());
+template <OneDimFloatingBaseType Base, typename C>
+   requires MaskOrPredicate<Base, C>
+STRICT_NODISCARD auto mean_if(const Base& A, const C& c) {
+   const auto k = count_if(A, c);
+   ASSERT_STRICT_DEBUG(k > 0_sl);
+   return sum_if(A, c) / value_type_cast<Base>(k);
 }
 
 
-template <typename Base, typename F>
-   requires(OneDimRealBaseType<RemoveRef<Base>> && CallableArgs1<Base, F> && !ArrayOneDimRealTypeRvalue<Base>)
-STRICT_CONSTEXPR auto in_cond_range(Base&& A, F f) {
-   std::vector<ImplicitInt> indexes;
-   std::ranges::copy_if(irange(A), std::back_inserter(indexes), [&](auto i) { return bool{f(A.index(i))}; });
-   return A(indexes);
+template <OneDimRealBaseType Base, typename C>
+   requires MaskOrPredicate<Base, C>
+STRICT_NODISCARD auto min_if(const Base& A, const C& c) {
+   using T = RealTypeOf<Base>;
+   ASSERT_STRICT_DEBUG(count_if(A, c) > 0_sl);
+   return Strict{internal::masked_reduce(A.size().val(), internal::element_get(A), internal::mask_keep(A, c),
+                                         internal::min_identity<T>, [](T x, T y) { return y < x ? y : x; })};
 }
 
 
-// !IsConst is not used since A might not be modified
-// Removed NonConstBaseType requirement so that for each can be
-// called for expression templates as well
-template <typename Base, typename F>
-   requires(ForCallable<Base, F>)
-STRICT_CONSTEXPR void for_each(Base&& A, F f) {
-   for(index_t i = 0_sl; i < A.size(); ++i) {
-      f(A.index(i));
-   }
+template <OneDimRealBaseType Base, typename C>
+   requires MaskOrPredicate<Base, C>
+STRICT_NODISCARD auto max_if(const Base& A, const C& c) {
+   using T = RealTypeOf<Base>;
+   ASSERT_STRICT_DEBUG(count_if(A, c) > 0_sl);
+   return Strict{internal::masked_reduce(A.size().val(), internal::element_get(A), internal::mask_keep(A, c),
+                                         internal::max_identity<T>, [](T x, T y) { return y > x ? y : x; })};
 }
 
 
-// A is allowed to be empty
-template <typename Base, typename F>
-   requires(NonConstBaseType<RemoveRef<Base>> && SortableArgs<Base, F> && !IsConst<RemoveRef<Base>>
-            && !ArrayOneDimRealTypeRvalue<Base>)
-STRICT_CONSTEXPR void sort(Base&& A, F f) {
-   std::sort(A.begin(), A.end(), f);
+template <OneDimFloatingBaseType Base, typename C>
+   requires MaskOrPredicate<Base, C>
+STRICT_NODISCARD auto norm2_if(const Base& A, const C& c) {
+   using T = RealTypeOf<Base>;
+   auto get = [&A](long int i) {
+      const T x = A.index(i).val();
+      return x * x;
+   };
+   return sqrts(Strict{internal::masked_reduce(A.size().val(), get, internal::mask_keep(A, c), T(0),
+                                               [](T x, T y) { return x + y; })});
 }
 
 
-template <typename Base>
-   requires(NonConstBaseType<RemoveRef<Base>> && !IsConst<RemoveRef<Base>>
-            && !ArrayOneDimRealTypeRvalue<Base>)
-STRICT_CONSTEXPR void sort_increasing(Base&& A) {
-   std::sort(A.begin(), A.end(), [](const auto& a, const auto& b) { return a < b; });
+template <BaseType Base>
+STRICT_CONSTEXPR void eval_into(const Base& A, BuiltinTypeOf<Base>* out) {
+   ASSERT_STRICT_DEBUG(A.size() == 0_sl || out != nullptr);
+   for(index_t i = 0_sl; i < A.size(); ++i) {
+      out[i.val()] = A.index(i).val();
+   }
 }
 
 
-template <typename Base>
-   requires(NonConstBaseType<RemoveRef<Base>> && !IsConst<RemoveRef<Base>>
-            && !ArrayOneDimRealTypeRvalue<Base>)
-STRICT_CONSTEXPR void sort_decreasing(Base&& A) {
-   std::sort(A.begin(), A.end(), [](const auto& a, const auto& b) { return a > b; });
+template <OneDimBaseType Base, AlignmentFlag AF>
+STRICT_CONSTEXPR void eval_into(const Base& A, Array1D<BuiltinTypeOf<Base>, AF>& out) {
+   if(out.size() == A.size()) {
+      internal::copy(A, out);
+   } else {
+      // A may refer to out, so that out is not resized before A is evaluated
+      Array1D<BuiltinTypeOf<Base>, AF> B(A);
+      out.swap(B);
+   }
 }
 
 
-template <typename Base>
+template <OneDimBaseType Base, typename Out>
+   requires(OneDimNonConstBaseType<RemoveRef<Out>> && !Array1DType<RemoveRef<Out>>)
+STRICT_CONSTEXPR void eval_into(const Base& A, Out&& out) {
+   ASSERT_STRICT_DEBUG(same_size(A, out));
+   internal::copy(A, out);
+}
+
+
+// elements are not value-initialized since all of them are overwritten
+template <RealBaseType Base>
+STRICT_CONSTEXPR_2023 std::unique_ptr<RealTypeOf<Base>[]> blas_array(const Base& A) {
+   if(A.empty()) {
+      return nullptr;
+   }
+
+   auto blas_array = std::make_unique_for_overwrite<RealTypeOf<Base>[]>(to_size_t(A.size()));
+   eval_into(A, blas_array.get());
+   return blas_array;
+}
+
+
+namespace internal {
+
+
+// number of elements processed by one task during stream compaction
+static constexpr inline long int compact_chunk = 1L << 14;
+
+
+// Stream compaction. f(i) is evaluated once for each i in [0, n) and the results are stored as bytes.
+// alloc(m) is called with the number m of i for which f(i) is true, and then out(k, i) is called for
+// the k-th such i. Both passes run in parallel; the second pass gathers selected i of blocks into
+// a buffer without branches, and chunks write to offsets found by the prefix sum of their counts.
+template <typename F, typename Alloc, typename Out>
+void compact(long int n, F f, Alloc alloc, Out out) {
+   const long int nchunks = chunk_count(n, compact_chunk);
+   auto mask = std::make_unique_for_overwrite<unsigned char[]>(static_cast<std::size_t>(n));
+   std::vector<long int> offset(static_cast<std::size_t>(nchunks + 1));
+
+   parallel_for_range(n, compact_chunk, [&](long int first, long int last) {
+      const long int c = first / compact_chunk;
+      long int k = 0;
+      for(long int i = first; i < last; ++i) {
+         const bool b = f(i);
+         mask[i] = b;
+         k += b;
+      }
+      offset[static_cast<std::size_t>(c + 1)] = k;
+   });
+   for(long int c = 0; c < nchunks; ++c) {
+      offset[static_cast<std::size_t>(c + 1)] += offset[static_cast<std::size_t>(c)];
+   }
+
+   alloc(offset.back());
+   parallel_for_range(n, compact_chunk, [&](long int first, long int last) {
+      constexpr long int block = 256;
+      long int buffer[block];
+      long int k = offset[static_cast<std::size_t>(first / compact_chunk)];
+      for(long int b = first; b < last; b += block) {
+         long int m = 0;
+         for(long int i = b; i < std::min(last, b + block); ++i) {
+            buffer[m] = i;
+            m += mask[i];
+         }
+         for(long int t = 0; t < m; ++t) {
+            out(k++, buffer[t]);
+         }
+      }
+   });
+}
+
+
+template <typename Base, typename F>
+std::vector<ImplicitInt> compact_indexes(const Base& A, F f) {
+   std::vector<ImplicitInt> indexes;
+   compact(
+       A.size().val(), [&](long int i) { return bool{f(A.index(i))}; },
+       [&indexes](long int m) { indexes.resize(static_cast<std::size_t>(m)); },
+       [&indexes](long int k, long int i) { indexes[static_cast<std::size_t>(k)] = i; });
+   return indexes;
+}
+
+
+}  // namespace internal
+
+
+template <typename Base>
+   requires(OneDimRealBaseType<RemoveRef<Base>> && !ArrayOneDimRealTypeRvalue<Base>)
+STRICT_CONSTEXPR auto in_open_range(Base&& A, ValueTypeOf<Base> low, ValueTypeOf<Base> high) {
+   ASSERT_STRICT_DEBUG(low <= high);
+   return in_cond_range(std::forward<Base>(A), [low, high](auto x) { return x > low && x < high; });
+}
+
+
+// Same as above
+template <typename Base>
+   requires(OneDimRealBaseType<RemoveRef<Base>> && !ArrayOneDimRealTypeRvalue<Base>)
+STRICT_CONSTEXPR auto in_open_range(Base&& A, Low<RealTypeOf<Base>> low, High<RealTypeOf<Base>> high) {
+   return in_open_range(std::forward<Base>(A), low.get(), high.get());
+}
+
+
+template <typename Base>
+   requires(OneDimRealBaseType<RemoveRef<Base>> && !ArrayOneDimRealTypeRvalue<Base>)
+STRICT_CONSTEXPR auto in_closed_range(Base&& A, ValueTypeOf<Base> low, ValueTypeOf<Base> high) {
+   ASSERT_STRICT_DEBUG(low <= high);
+   return in_cond_range(std::forward<Base>(A), [low, high](auto x) { return x >= low && x <= high; });
+}
+
+
+template <typename Base>
+   requires(OneDimRealBaseType<RemoveRef<Base>> && !ArrayOneDimRealTypeRvalue<Base>)
+STRICT_CONSTEXPR auto in_closed_range(Base&& A, Low<RealTypeOf<Base>> low, High<RealTypeOf<Base>> high) {
+   return in_closed_range(std::forward<Base>(A), low.get(), high.get());
+}
+
+
+template <typename Base, typename F>
+   requires(OneDimRealBaseType<RemoveRef<Base>> && CallableArgs1<Base, F> && !ArrayOneDimRealTypeRvalue<Base>)
+STRICT_CONSTEXPR auto in_cond_range(Base&& A, F f) {
+   if(std::is_constant_evaluated()) {
+      std::vector<ImplicitInt> indexes;
+      std::ranges::copy_if(irange(A), std::back_inserter(indexes), [&](auto i) { return bool{f(A.index(i))}; });
+      return A(std::move(indexes));
+   }
+   return A(internal::compact_indexes(A, f));
+}
+
+
+// A is allowed to be empty
+// returns array of all elements that evaluate true for f, in the same order as in A
+template <typename Base, typename F>
+   requires(OneDimRealBaseType<RemoveRef<Base>> && CallableArgs1<Base, F>)
+STRICT_NODISCARD auto filter(const Base& A, F f) {
+   Array1D<BuiltinTypeOf<Base>> R;
+   internal::compact(
+       A.size().val(), [&](long int i) { return bool{f(A.index(i))}; },
+       [&R](long int m) { R.resize(index_t{m}); }, [&](long int k, long int i) { R.index(k) = A.index(i); });
+   return R;
+}
+
+
+// A is allowed to be empty
+// returns indexes of all elements that evaluate true for f in increasing order
+template <typename Base, typename F>
+   requires(OneDimRealBaseType<RemoveRef<Base>> && CallableArgs1<Base, F>)
+STRICT_NODISCARD Array1D<long int> filter_indexes(const Base& A, F f) {
+   Array1D<long int> R;
+   internal::compact(
+       A.size().val(), [&](long int i) { return bool{f(A.index(i))}; },
+       [&R](long int m) { R.resize(index_t{m}); }, [&R](long int k, long int i) { R.index(k) = Strict{i}; });
+   return R;
+}
+
+
+// !IsConst is not used since A might not be modified
+// Removed NonConstBaseType requirement so that for each can be
+// called for expression templates as well
+template <typename Base, typename F>
+   requires(ForCallable<Base, F>)
+STRICT_CONSTEXPR void for_each(Base&& A, F f) {
+   for(index_t i = 0_sl; i < A.size(); ++i) {
+      f(A.index(i));
+   }
+}
+
+
+namespace internal {
+
+
+// pointer to the first element if elements of A are stored contiguously, nullptr otherwise
+template <typename Base>
+ValueTypeOf<Base>* contiguous_data(Base& A) {
+   if constexpr(StridedOneDimType<Base>) {
+      if(!A.empty() && strided_data(A).second == 1) {
+         return &A.index(0);
+      }
+   }
+   return nullptr;
+}
+
+
+// calls f(pointer, size) on contiguous elements of A; other arrays are gathered into
+// a temporary array, which is scattered back to A afterwards
+template <typename Base, typename F>
+void with_contiguous(Base& A, F f) {
+   if(auto* p = contiguous_data(A)) {
+      f(p, A.size().val());
+   } else if(A.size() > 1_sl) {
+      Array1D<BuiltinTypeOf<Base>> B(A);
+      f(B.data(), B.size().val());
+      A = B;
+   }
+}
+
+
+template <typename T>
+void sort_range(Strict<T>* x, long int n, bool decreasing) {
+   if constexpr(RadixSortable<T>) {
+      if(n >= radix_threshold) {
+         radix_sort(x, n, decreasing);
+         return;
+      }
+   }
+   if(decreasing) {
+      parallel_sort(x, n, [](const auto& a, const auto& b) { return bool{a > b}; });
+   } else {
+      parallel_sort(x, n, [](const auto& a, const auto& b) { return bool{a < b}; });
+   }
+}
+
+
+template <typename Base>
+void sort_ordered(Base& A, bool decreasing) {
+   using T = BuiltinTypeOf<Base>;
+   with_contiguous(A, [decreasing](Strict<T>* x, long int n) { sort_range(x, n, decreasing); });
+}
+
+
+// long ranges of radix sortable types are partitioned in parallel when several threads are available
+template <typename T>
+void nth_element_range(Strict<T>* x, long int n, long int k) {
+   if constexpr(RadixSortable<T>) {
+      if(n > parallel_threshold && max_threads() > 1) {
+         radix_nth_element(x, n, k);
+         return;
+      }
+   }
+   std::nth_element(x, x + k, x + n, [](const auto& a, const auto& b) { return bool{a < b}; });
+}
+
+
+// long ranges of radix sortable types are partitioned at k - 1 and their first k elements are sorted
+template <typename T>
+void partial_sort_range(Strict<T>* x, long int n, long int k) {
+   if constexpr(RadixSortable<T>) {
+      if(n > parallel_threshold && max_threads() > 1) {
+         if(k > 0 && k < n) {
+            radix_nth_element(x, n, k - 1);
+         }
+         sort_range(x, k, false);
+         return;
+      }
+   }
+   std::partial_sort(x, x + k, x + n, [](const auto& a, const auto& b) { return bool{a < b}; });
+}
+
+
+}  // namespace internal
+
+
+// Large arrays are sorted in parallel. sort_increasing and sort_decreasing use radix sort
+// for integers, float, and double. Strided and random slices are sorted in a temporary array.
+template <typename Base, typename F>
+   requires(NonConstBaseType<RemoveRef<Base>> && SortableArgs<Base, F> && !IsConst<RemoveRef<Base>>
+            && !ArrayOneDimRealTypeRvalue<Base>)
+STRICT_CONSTEXPR void sort(Base&& A, F f) {
+   if(std::is_constant_evaluated()) {
+      std::sort(A.begin(), A.end(), f);
+   } else {
+      internal::with_contiguous(A, [&f](auto* x, long int n) {
+         internal::parallel_sort(x, n, [&f](const auto& a, const auto& b) { return bool{f(a, b)}; });
+      });
+   }
+}
+
+
+template <typename Base>
+   requires(NonConstBaseType<RemoveRef<Base>> && !IsConst<RemoveRef<Base>>
+            && !ArrayOneDimRealTypeRvalue<Base>)
+STRICT_CONSTEXPR void sort_increasing(Base&& A) {
+   if(std::is_constant_evaluated()) {
+      std::sort(A.begin(), A.end(), [](const auto& a, const auto& b) { return a < b; });
+   } else {
+      internal::sort_ordered(A, false);
+   }
+}
+
+
+template <typename Base>
+   requires(NonConstBaseType<RemoveRef<Base>> && !IsConst<RemoveRef<Base>>
+            && !ArrayOneDimRealTypeRvalue<Base>)
+STRICT_CONSTEXPR void sort_decreasing(Base&& A) {
+   if(std::is_constant_evaluated()) {
+      std::sort(A.begin(), A.end(), [](const auto& a, const auto& b) { return a > b; });
+   } else {
+      internal::sort_ordered(A, true);
+   }
+}
+
+
+namespace internal {
+
+
+// indexes of A sorted by values of A; equal values keep the order of their indexes. For increasing
+// and decreasing orders, -0 equals +0, and NaNs are placed after all other values in increasing order
+// and before them in decreasing order.
+template <typename Base, typename F>
+std::vector<ImplicitInt> argsort_by(const Base& A, F comp, [[maybe_unused]] int radix_order) {
+   using T = BuiltinTypeOf<Base>;
+   using pair_type = std::pair<Strict<T>, long int>;
+   const long int n = A.size().val();
+
+   auto p = std::make_unique_for_overwrite<pair_type[]>(static_cast<std::size_t>(n));
+   parallel_for_range(n, sort_chunk, [&](long int first, long int last) {
+      for(long int i = first; i < last; ++i) {
+         p[i] = {A.index(i), i};
+      }
+   });
+
+   // increasing and decreasing orders of radix sortable types compare canonical keys, so that radix
+   // sort and comparison sort give the same order for signed zeros and NaNs
+   auto by_index = [](const auto& less, const pair_type& x, const pair_type& y) {
+      return less(x, y) || (!less(y, x) && x.second < y.second);
+   };
+   bool sorted = false;
+   if constexpr(RadixSortable<T>) {
+      if(radix_order != 0) {
+         auto key = [radix_order](const pair_type& x) {
+            const auto k = canonical_radix_key(x.first.val());
+            return radix_order > 0 ? k : static_cast<RadixKey<T>>(~k);
+         };
+         if(n >= radix_threshold) {
+            radix_sort_by(p.get(), n, key);
+         } else {
+            auto less = [&key](const pair_type& x, const pair_type& y) { return key(x) < key(y); };
+            parallel_sort(p.get(), n, [&](const pair_type& x, const pair_type& y) { return by_index(less, x, y); });
+         }
+         sorted = true;
+      }
+   }
+   if(!sorted) {
+      auto less = [&comp](const pair_type& x, const pair_type& y) { return comp(x.first, y.first); };
+      parallel_sort(p.get(), n, [&](const pair_type& x, const pair_type& y) { return by_index(less, x, y); });
+   }
+
+   std::vector<ImplicitInt> indexes(static_cast<std::size_t>(n));
+   parallel_for_range(n, sort_chunk, [&](long int first, long int last) {
+      for(long int i = first; i < last; ++i) {
+         indexes[static_cast<std::size_t>(i)] = p[i].second;
+      }
+   });
+   return indexes;
+}
+
+
+// A = A(indexes)
+template <typename Base>
+void permute(Base& A, const std::vector<ImplicitInt>& indexes) {
+   Array1D<BuiltinTypeOf<Base>> B(A.size());
+   const long int n = A.size().val();
+   parallel_for_range(n, sort_chunk, [&](long int first, long int last) {
+      for(long int i = first; i < last; ++i) {
+         B.index(i) = A.index(indexes[static_cast<std::size_t>(i)].get());
+      }
+   });
+   A = B;
+}
+
+
+}  // namespace internal
+
+
+// Indexes that sort A, which can be used as random slice A(argsort(A)). The sort is stable and
+// parallel; argsort_increasing and argsort_decreasing use radix sort for integers, float, and double,
+// treat -0 and +0 as equal, and place NaNs last in increasing order and first in decreasing order.
+template <typename Base, typename F>
+   requires(OneDimBaseType<RemoveRef<Base>> && SortableArgs<Base, F>)
+STRICT_NODISCARD std::vector<ImplicitInt> argsort(const Base& A, F f) {
+   return internal::argsort_by(A, [&f](const auto& a, const auto& b) { return bool{f(a, b)}; }, 0);
+}
+
+
+template <OneDimRealBaseType Base>
+STRICT_NODISCARD std::vector<ImplicitInt> argsort_increasing(const Base& A) {
+   return internal::argsort_by(A, [](const auto& a, const auto& b) { return bool{a < b}; }, 1);
+}
+
+
+template <OneDimRealBaseType Base>
+STRICT_NODISCARD std::vector<ImplicitInt> argsort_decreasing(const Base& A) {
+   return internal::argsort_by(A, [](const auto& a, const auto& b) { return bool{a > b}; }, -1);
+}
+
+
+// sorts keys in increasing order and permutes values in the same way; the sort is stable
+template <typename Base, typename... Bases>
+   requires(OneDimRealBaseType<RemoveRef<Base>> && NonConstBaseType<RemoveRef<Base>>
+            && !ArrayOneDimRealTypeRvalue<Base> && (... && NonConstBaseType<RemoveRef<Bases>>)
+            && (... && !ArrayOneDimTypeRvalue<Bases>))
+void sort_by_key(Base&& keys, Bases&&... values) {
+   ASSERT_STRICT_DEBUG((... && (values.size() == keys.size())));
+   const auto indexes = argsort_increasing(keys);
+   internal::permute(keys, indexes);
+   (..., internal::permute(values, indexes));
+}
+
+
+// k-th smallest element of A, starting from 0. A is not modified and is allowed to be an expression.
+// Integers, float, and double use parallel radix selection, which does not store A.
+// Other types are copied and selected by std::nth_element. A must not contain NaNs.
+template <OneDimRealBaseType Base>
+STRICT_NODISCARD auto nth_value(const Base& A, ImplicitInt k) {
+   using T = BuiltinTypeOf<Base>;
+   ASSERT_STRICT_DEBUG(k.get() >= 0_sl && k.get() < A.size());
+   const long int n = A.size().val();
+
+   if constexpr(internal::RadixSortable<T>) {
+      return Strict{internal::radix_select<T>(n, k.get().val(), [&A](long int i) { return A.index(i).val(); })};
+   } else {
+      Array1D<T> B(A);
+      std::nth_element(B.data(), B.data() + k.get().val(), B.data() + n,
+                       [](const auto& a, const auto& b) { return bool{a < b}; });
+      return B[k];
+   }
+}
+
+
+template <FloatingBaseType Base>
+STRICT_NODISCARD auto median(const Base& A) {
+   ASSERT_STRICT_DEBUG(!A.empty());
+   using T = RealTypeOf<Base>;
+   const auto n = A.size();
+   if(n % 2_sl == 1_sl) {
+      return nth_value(A, n / 2_sl);
+   }
+   return (nth_value(A, n / 2_sl - 1_sl) + nth_value(A, n / 2_sl)) / Strict<T>{T(2)};
+}
+
+
+// rearranges A so that A[k] is the element that would be there if A was sorted in increasing order,
+// elements before it are not greater, and elements after it are not smaller. Long arrays of integers,
+// float, and double are partitioned in parallel around the value found by radix selection; other
+// types, short arrays, and single threaded runs use std::nth_element. A must not contain NaNs.
+template <typename Base>
+   requires(NonConstBaseType<RemoveRef<Base>> && OneDimRealBaseType<RemoveRef<Base>>
+            && !ArrayOneDimRealTypeRvalue<Base>)
+void nth_element(Base&& A, ImplicitInt k) {
+   ASSERT_STRICT_DEBUG(k.get() >= 0_sl && k.get() < A.size());
+   internal::with_contiguous(A, [k](auto* x, long int n) { internal::nth_element_range(x, n, k.get().val()); });
+}
+
+
+// the smallest k elements of A are sorted in increasing order and placed at the beginning of A.
+// Long arrays of integers, float, and double are partitioned by nth_element, after which the
+// first k elements are sorted in parallel; other types, short arrays, and single threaded runs
+// use std::partial_sort.
+// A must not contain NaNs.
+template <typename Base>
+   requires(NonConstBaseType<RemoveRef<Base>> && OneDimRealBaseType<RemoveRef<Base>>
+            && !ArrayOneDimRealTypeRvalue<Base>)
+void partial_sort(Base&& A, ImplicitInt k) {
+   ASSERT_STRICT_DEBUG(k.get() >= 0_sl && k.get() <= A.size());
+   internal::with_contiguous(A, [k](auto* x, long int n) { internal::partial_sort_range(x, n, k.get().val()); });
+}
+
+
+// k largest elements of A in decreasing order and their indexes; equal elements are ordered by
+// their indexes. Elements are read once by every pass of radix selection and once more when
+// they are compared to the k-th largest element, so that expressions are evaluated into an array first.
+template <OneDimRealBaseType Base>
+STRICT_NODISCARD auto top_k(const Base& A, ImplicitInt k) {
+   using T = BuiltinTypeOf<Base>;
+   using pair_type = std::pair<Strict<T>, long int>;
+   ASSERT_STRICT_DEBUG(k.get() >= 0_sl && k.get() <= A.size());
+   if constexpr(!NonConstBaseType<Base> && !ConstSliceBaseType<Base>) {
+      return top_k(Array1D<T>(A), k);
+   }
+   const long int n = A.size().val();
+   const long int kv = k.get().val();
+
+   std::vector<pair_type> top;
+   if(kv > 0) {
+      // elements greater than the threshold and the first elements equal to it
+      const auto threshold = nth_value(A, n - kv);
+      const long int nchunks = internal::chunk_count(n, internal::sort_chunk);
+      std::vector<std::vector<pair_type>> greater(static_cast<std::size_t>(nchunks));
+      std::vector<std::vector<pair_type>> equal(static_cast<std::size_t>(nchunks));
+      internal::parallel_for_range(n, internal::sort_chunk, [&](long int first, long int last) {
+         const long int c = first / internal::sort_chunk;
+         for(long int i = first; i < last; ++i) {
+            if(const auto x = A.index(i); x > threshold) {
+               greater[static_cast<std::size_t>(c)].push_back({x, i});
+            } else if(x == threshold) {
+               equal[static_cast<std::size_t>(c)].push_back({x, i});
+            }
+         }
+      });
+
+      top.reserve(static_cast<std::size_t>(kv));
+      for(const auto& g : greater) {
+         top.insert(top.end(), g.begin(), g.end());
+      }
+      for(const auto& e : equal) {
+         for(auto it = e.begin(); it != e.end() && static_cast<long int>(top.size()) < kv; ++it) {
+            top.push_back(*it);
+         }
+      }
+      std::sort(top.begin(), top.end(), [](const pair_type& x, const pair_type& y) {
+         return x.first > y.first || (x.first == y.first && x.second < y.second);
+      });
+   }
+
+   std::pair<Array1D<T>, std::vector<ImplicitInt>> r{Array1D<T>(k.get()), std::vector<ImplicitInt>{}};
+   r.second.reserve(static_cast<std::size_t>(kv));
+   for(long int i = 0; i < kv; ++i) {
+      r.first.index(i) = top[static_cast<std::size_t>(i)].first;
+      r.second.emplace_back(top[static_cast<std::size_t>(i)].second);
+   }
+   return r;
+}
+
+
+namespace internal {
+
+
+// number of elements shuffled serially by one task
+static constexpr inline long int shuffle_chunk = 1L << 16;
+
+
+// random bits drawn one at a time from an engine
+class RandomBits {
+public:
+   explicit RandomBits(Philox4x32& g) : g_{g}, bits_{}, left_{0} {
+   }
+
+   bool operator()() {
+      if(left_ == 0) {
+         bits_ = g_();
+         left_ = 64;
+      }
+      --left_;
+      const bool b = bits_ & 1;
+      bits_ >>= 1;
+      return b;
+   }
+
+private:
+   Philox4x32& g_;
+   std::uint64_t bits_;
+   int left_;
+};
+
+
+// Fisher-Yates shuffle of A[first, last)
+template <typename Base>
+void fisher_yates(Base& A, long int first, long int last, Philox4x32& g) {
+   for(long int i = last - 1; i > first; --i) {
+      std::swap(A.index(i), A.index(uniform_int(g, first, i)));
+   }
+}
+
+
+// merges randomly shuffled A[first, mid) and A[mid, last) into randomly shuffled A[first, last)
+template <typename Base>
+void merge_shuffled(Base& A, long int first, long int mid, long int last, Philox4x32& g) {
+   RandomBits bit{g};
+   long int i = first;
+   long int j = mid;
+   while(true) {
+      if(bit()) {
+         if(j == last) {
+            break;
+         }
+         std::swap(A.index(i), A.index(j++));
+      } else if(i == j) {
+         break;
+      }
+      ++i;
+   }
+   for(; i < last; ++i) {
+      std::swap(A.index(i), A.index(uniform_int(g, first, i)));
+   }
+}
+
+
+// MergeShuffle of Bacher, Bodini, Hollender, and Lumbroso: chunks are shuffled independently and then
+// merged pairwise. Every chunk and every merge uses its own Philox stream, and the chunk size does not
+// depend on the number of threads, so that the result only depends on the seed.
+template <typename Base>
+void merge_shuffle(Base& A, std::uint64_t seed) {
+   const long int n = A.size().val();
+   const long int nchunks = chunk_count(n, shuffle_chunk);
+
+   parallel_for_range(n, shuffle_chunk, [&](long int first, long int last) {
+      Philox4x32 g{seed, static_cast<std::uint64_t>(first / shuffle_chunk)};
+      fisher_yates(A, first, last, g);
+   });
+
+   std::uint64_t stream = static_cast<std::uint64_t>(nchunks);
+   for(long int width = shuffle_chunk; width < n; width *= 2) {
+      const long int nmerges = chunk_count(n, 2 * width);
+      parallel_for(nmerges, [&](long int c) {
+         const long int first = 2 * width * c;
+         const long int mid = std::min(n, first + width);
+         if(mid < n) {
+            Philox4x32 g{seed, stream + static_cast<std::uint64_t>(c)};
+            merge_shuffled(A, first, mid, std::min(n, first + 2 * width), g);
+         }
+      });
+      stream += static_cast<std::uint64_t>(nmerges);
+   }
+}
+
+
+}  // namespace internal
+
+
+template <typename Base>
+   requires(NonConstBaseType<RemoveRef<Base>> && !IsConst<RemoveRef<Base>>
+            && !ArrayOneDimRealTypeRvalue<Base>)
+void shuffle(Base&& A, std::uint64_t seed) {
+   internal::merge_shuffle(A, seed);
+}
+
+
+template <typename Base>
    requires(NonConstBaseType<RemoveRef<Base>> && !IsConst<RemoveRef<Base>>
             && !ArrayOneDimRealTypeRvalue<Base>)
 void shuffle(Base&& A) {
-   std::mt19937 g{std::random_device{}()};
-   std::shuffle(A.begin(), A.end(), g);
+   internal::merge_shuffle(A, internal::thread_engine()());
+}
+
+
+// random permutation of 0, 1, ..., n - 1
+STRICT_NODISCARD_INLINE Array1D<long int> random_permutation(ImplicitInt n, std::uint64_t seed) {
+   Array1D<long int> p(n);
+   internal::parallel_for_range(p.size().val(), internal::shuffle_chunk, [&p](long int first, long int last) {
+      for(long int i = first; i < last; ++i) {
+         p.index(i) = Strict{i};
+      }
+   });
+   internal::merge_shuffle(p, seed);
+   return p;
+}
+
+
+STRICT_NODISCARD_INLINE Array1D<long int> random_permutation(ImplicitInt n) {
+   return random_permutation(n, internal::thread_engine()());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// SearchLeft finds the first position i such that sorted[i] >= q,
+// SearchRight finds the first position i such that sorted[i] > q
+enum SearchFlag { SearchLeft, SearchRight };
+
+
+namespace internal {
+
+
+// number of queries processed by one task
+static constexpr inline long int search_chunk = 1L << 12;
+
+
+template <typename T>
+struct IsSequence {
+   static constexpr bool value = false;
+};
+
+
+template <Real T>
+struct IsSequence<Derived1D<SequenceExpr1D<T>>> {
+   static constexpr bool value = true;
+};
+
+
+// true if x is placed before q
+template <SearchFlag SF, typename T>
+STRICT_CONSTEXPR_INLINE bool search_before(T x, T q) {
+   if constexpr(SF == SearchLeft) {
+      return x < q;
+   } else {
+      return !(q < x);
+   }
+}
+
+
+// get is a pointer to contiguous elements or a function that returns elements
+template <typename F>
+STRICT_INLINE auto search_at(F get, long int i) {
+   if constexpr(std::is_pointer_v<F>) {
+      return get[i];
+   } else {
+      return get(i);
+   }
+}
+
+
+// number of elements get(first), ..., get(first + n - 1) placed before q; the loop has a fixed number
+// of iterations for a given n and compiles to conditional moves
+template <SearchFlag SF, typename F, typename T>
+STRICT_INLINE long int branchless_search(F get, long int first, long int n, T q) {
+   if(n == 0) {
+      return 0;
+   }
+   long int base = first;
+   while(n > 1) {
+      const long int half = n / 2;
+#if defined(__GNUC__) || defined(__clang__)
+      // both possible next midpoints
+      if constexpr(std::is_pointer_v<F>) {
+         __builtin_prefetch(get + base + half / 2);
+         __builtin_prefetch(get + base + half + half / 2);
+      }
+#endif
+      base = search_before<SF>(search_at(get, base + half), q) ? base + half : base;
+      n -= half;
+   }
+   return base - first + search_before<SF>(search_at(get, base), q);
+}
+
+
+// position of q, given that all elements before p are placed before q;
+// exponential search from p takes O(log d) steps, where d is the distance to the result
+template <SearchFlag SF, typename F, typename T>
+STRICT_INLINE long int gallop_search(F get, long int n, long int p, T q) {
+   long int lo = p;
+   long int hi = p;
+   for(long int step = 1; hi < n && search_before<SF>(search_at(get, hi), q); step *= 2) {
+      lo = hi + 1;
+      hi = lo + step;
+   }
+   hi = std::min(hi, n);
+   return lo + branchless_search<SF>(get, lo, hi - lo, q);
+}
+
+
+// position of q in arithmetic sequence get(0), get(1), ... with positive increment computed in O(1);
+// the difference is taken in double, since q - start wraps for unsigned and overflows for signed types
+template <SearchFlag SF, typename F, typename T>
+STRICT_INLINE long int sequence_search(F get, long int n, T start, T incr, T q) {
+   double g = std::ceil((static_cast<double>(q) - static_cast<double>(start)) / static_cast<double>(incr));
+   // also replaces NaN
+   if(!(g >= 0.)) {
+      g = 0.;
+   }
+   long int i = g < static_cast<double>(n) ? static_cast<long int>(g) : n;
+   // corrects rounding errors and equal elements
+   while(i < n && search_before<SF>(get(i), q)) {
+      ++i;
+   }
+   while(i > 0 && !search_before<SF>(get(i - 1), q)) {
+      --i;
+   }
+   return i;
+}
+
+
+template <SearchFlag SF, typename Base1, typename Base2>
+Array1D<long int> searchsorted(const Base1& sorted, const Base2& queries) {
+   using T = BuiltinTypeOf<Base1>;
+   const long int n = sorted.size().val();
+   const long int m = queries.size().val();
+   Array1D<long int> pos(queries.size());
+
+   auto search_all = [&](auto get, auto search_one) {
+      // increasing queries are searched from the position of the previous query
+      bool increasing = true;
+      for(long int i = 1; i < m && increasing; ++i) {
+         increasing = !(queries.index(i).val() < queries.index(i - 1).val());
+      }
+      parallel_for_range(m, search_chunk, [&](long int first, long int last) {
+         long int p = 0;
+         for(long int i = first; i < last; ++i) {
+            const T q = queries.index(i).val();
+            p = increasing && i != first ? gallop_search<SF>(get, n, p, q) : search_one(get, q);
+            pos.index(i) = Strict{p};
+         }
+      });
+   };
+
+   if constexpr(IsSequence<Base1>::value) {
+      if(n > 1 && sorted.index(1) > sorted.index(0)) {
+         const T start = sorted.index(0).val();
+         const T incr = sorted.index(1).val() - start;
+         auto get = [&sorted](long int i) { return sorted.index(i).val(); };
+         parallel_for_range(m, search_chunk, [&](long int first, long int last) {
+            for(long int i = first; i < last; ++i) {
+               pos.index(i) = Strict{sequence_search<SF>(get, n, start, incr, queries.index(i).val())};
+            }
+         });
+         return pos;
+      }
+   }
+
+   auto search_one = [n](auto get, T q) { return branchless_search<SF>(get, 0, n, q); };
+   if constexpr(StridedOneDimType<Base1>) {
+      if(auto [data, stride] = strided_data(sorted); stride == 1) {
+         search_all(data, search_one);
+         return pos;
+      }
+   }
+   search_all([&sorted](long int i) { return sorted.index(i).val(); }, search_one);
+   return pos;
+}
+
+
+}  // namespace internal
+
+
+// Sorted array stored in the Eytzinger(breadth-first) order of a complete binary search tree, in which
+// the first levels of the tree share cache lines and the next levels can be prefetched. Searches in
+// large arrays access memory in a more cache friendly way than binary search of a sorted array.
+template <Real T>
+class Eytzinger {
+public:
+   using value_type = Strict<T>;
+
+   // sorted must be sorted in increasing order
+   template <OneDimRealBaseType Base>
+      requires SameAs<BuiltinTypeOf<Base>, T>
+   explicit Eytzinger(const Base& sorted)
+       : b_(static_cast<std::size_t>(sorted.size().val() + 1)),
+         rank_(static_cast<std::size_t>(sorted.size().val() + 1)) {
+      const long int n = sorted.size().val();
+      long int i = 0;
+      // in-order traversal of the tree visits its nodes in sorted order
+      auto build = [&](auto& self, long int k) -> void {
+         if(k <= n) {
+            self(self, 2 * k);
+            b_[static_cast<std::size_t>(k)] = sorted.index(i).val();
+            rank_[static_cast<std::size_t>(k)] = i++;
+            self(self, 2 * k + 1);
+         }
+      };
+      build(build, 1);
+      rank_[0] = n;
+   }
+
+   STRICT_NODISCARD index_t size() const {
+      return from_size_t<long int>(b_.size()) - 1_sl;
+   }
+
+   // position of q in the sorted array
+   template <SearchFlag SF = SearchLeft>
+   STRICT_NODISCARD long int search(T q) const {
+      constexpr auto line = static_cast<std::size_t>(64 / sizeof(T));
+      const std::size_t n = b_.size() - 1;
+      std::size_t k = 1;
+      while(k <= n) {
+#if defined(__GNUC__) || defined(__clang__)
+         if(line * k <= n) {
+            __builtin_prefetch(b_.data() + line * k);
+         }
+#endif
+         k = 2 * k + static_cast<std::size_t>(internal::search_before<SF>(b_[k], q));
+      }
+      // removes trailing right turns and the last left turn
+      k >>= std::countr_one(k) + 1;
+      return rank_[k];
+   }
+
+private:
+   std::vector<T> b_;  // b_[0] is not used
+   std::vector<long int> rank_;
+};
+
+
+// Positions in sorted array at which queries would be inserted to keep it sorted. Searches
+// are branchless and run in parallel. Increasing queries are found by exponential search
+// from the previous result, and positions in sequences(e.g. linspace) are computed in O(1).
+template <OneDimRealBaseType Base1, OneDimRealBaseType Base2>
+   requires SameAs<BuiltinTypeOf<Base1>, BuiltinTypeOf<Base2>>
+STRICT_NODISCARD Array1D<long int> searchsorted(const Base1& sorted, const Base2& queries,
+                                                SearchFlag sf = SearchLeft) {
+   return sf == SearchLeft ? internal::searchsorted<SearchLeft>(sorted, queries)
+                           : internal::searchsorted<SearchRight>(sorted, queries);
+}
+
+
+template <Real T, OneDimRealBaseType Base>
+   requires SameAs<T, BuiltinTypeOf<Base>>
+STRICT_NODISCARD Array1D<long int> searchsorted(const Eytzinger<T>& sorted, const Base& queries,
+                                                SearchFlag sf = SearchLeft) {
+   const long int m = queries.size().val();
+   Array1D<long int> pos(queries.size());
+   internal::parallel_for_range(m, internal::search_chunk, [&](long int first, long int last) {
+      for(long int i = first; i < last; ++i) {
+         const T q = queries.index(i).val();
+         pos.index(i)
+             = Strict{sf == SearchLeft ? sorted.template search<SearchLeft>(q) : sorted.template search<SearchRight>(q)};
+      }
+   });
+   return pos;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace internal {
+
+
+// calls f(get), where get is a pointer to elements of A if they are stored contiguously,
+// and a function that returns A.index(i).val() otherwise
+template <typename Base, typename F>
+decltype(auto) with_reader(const Base& A, F f) {
+   if constexpr(StridedOneDimType<Base>) {
+      if(auto [data, stride] = strided_data(A); stride == 1) {
+         return f(data);
+      }
+   }
+   return f([&A](long int i) { return A.index(i).val(); });
+}
+
+
+// writes or counts results of a chunk
+template <typename T>
+class SetOutput {
+public:
+   explicit SetOutput(Strict<T>* out) : out_{out}, n_{0} {
+   }
+
+   STRICT_INLINE void operator()(T x) {
+      if(out_ != nullptr) {
+         out_[n_] = Strict{x};
+      }
+      ++n_;
+   }
+
+   // x is stored if keep is true
+   STRICT_INLINE void operator()(T x, bool keep) {
+      if(out_ != nullptr && keep) {
+         out_[n_] = Strict{x};
+      }
+      n_ += keep;
+   }
+
+   STRICT_NODISCARD long int count() const {
+      return n_;
+   }
+
+private:
+   Strict<T>* out_;
+   long int n_;
+};
+
+
+// Chunks are processed twice: the first pass counts the results and the second pass writes
+// them to offsets found by the prefix sum of counts, so that the output is allocated once.
+// f(c, out) processes chunk c.
+template <typename T, typename F>
+Array1D<T> chunked_output(long int nchunks, F f) {
+   std::vector<long int> offset(static_cast<std::size_t>(nchunks + 1));
+   parallel_for(nchunks, [&](long int c) {
+      SetOutput<T> out{nullptr};
+      f(c, out);
+      offset[static_cast<std::size_t>(c + 1)] = out.count();
+   });
+   for(long int c = 0; c < nchunks; ++c) {
+      offset[static_cast<std::size_t>(c + 1)] += offset[static_cast<std::size_t>(c)];
+   }
+
+   Array1D<T> R(offset.back());
+   auto* r = R.data();
+   parallel_for(nchunks, [&](long int c) {
+      SetOutput<T> out{r + offset[static_cast<std::size_t>(c)]};
+      f(c, out);
+   });
+   return R;
+}
+
+
+// boundaries of chunks of sorted a of size na that do not split runs of equal elements, and
+// corresponding boundaries of sorted b, so that chunks of a and b can be processed independently
+template <typename F1, typename F2>
+auto set_partition(F1 a, long int na, F2 b, long int nb) {
+   const long int nchunks = std::max(chunk_count(na, sort_chunk), 1L);
+   std::vector<long int> ia(static_cast<std::size_t>(nchunks + 1)), ib(static_cast<std::size_t>(nchunks + 1));
+   ia.back() = na;
+   ib.back() = nb;
+   for(long int c = 1; c < nchunks; ++c) {
+      long int i = std::max(c * sort_chunk, ia[static_cast<std::size_t>(c - 1)]);
+      while(i < na && i > 0 && search_at(a, i) == search_at(a, i - 1)) {
+         ++i;
+      }
+      ia[static_cast<std::size_t>(c)] = i;
+      ib[static_cast<std::size_t>(c)] = i < na ? branchless_search<SearchLeft>(b, 0, nb, search_at(a, i)) : nb;
+   }
+   return std::pair{std::move(ia), std::move(ib)};
+}
+
+
+enum SetOperation { SetUnion, SetIntersection, SetDifference };
+
+
+// multiset semantics of std::set_union, std::set_intersection, and std::set_difference;
+// the main loop advances positions by results of comparisons instead of branching on them
+template <SetOperation SO, typename T, typename F1, typename F2>
+void set_merge(F1 a, long int i, long int ie, F2 b, long int j, long int je, SetOutput<T>& out) {
+   while(i < ie && j < je) {
+      const T x = search_at(a, i);
+      const T y = search_at(b, j);
+      if constexpr(SO == SetUnion) {
+         out(y < x ? y : x);
+      } else if constexpr(SO == SetIntersection) {
+         out(x, x == y);
+      } else {
+         out(x, x < y);
+      }
+      i += x <= y;
+      j += y <= x;
+   }
+   if constexpr(SO != SetIntersection) {
+      for(; i < ie; ++i) {
+         out(search_at(a, i));
+      }
+   }
+   if constexpr(SO == SetUnion) {
+      for(; j < je; ++j) {
+         out(search_at(b, j));
+      }
+   }
+}
+
+
+template <SetOperation SO, typename Base1, typename Base2>
+auto set_operation(const Base1& A, const Base2& B) {
+   using T = BuiltinTypeOf<Base1>;
+   const long int na = A.size().val();
+   const long int nb = B.size().val();
+   return with_reader(A, [&](auto a) {
+      return with_reader(B, [&](auto b) {
+         const auto p = set_partition(a, na, b, nb);
+         const auto& ia = p.first;
+         const auto& ib = p.second;
+         return chunked_output<T>(static_cast<long int>(ia.size()) - 1, [&](long int c, SetOutput<T>& out) {
+            const auto k = static_cast<std::size_t>(c);
+            set_merge<SO>(a, ia[k], ia[k + 1], b, ib[k], ib[k + 1], out);
+         });
+      });
+   });
+}
+
+
+}  // namespace internal
+
+
+// Functions below require arrays sorted in increasing order without NaNs. They run in parallel:
+// sorted arrays are split into chunks that do not split runs of equal elements.
+template <OneDimRealBaseType Base>
+STRICT_NODISCARD auto unique(const Base& A) {
+   using T = BuiltinTypeOf<Base>;
+   const long int n = A.size().val();
+   return internal::with_reader(A, [n](auto a) {
+      return internal::chunked_output<T>(internal::chunk_count(n, internal::sort_chunk),
+                                         [a, n](long int c, internal::SetOutput<T>& out) {
+                                            const long int last = std::min(n, (c + 1) * internal::sort_chunk);
+                                            for(long int i = c * internal::sort_chunk; i < last; ++i) {
+                                               const T x = internal::search_at(a, i);
+                                               if(i == 0 || x != internal::search_at(a, i - 1)) {
+                                                  out(x);
+                                               }
+                                            }
+                                         });
+   });
+}
+
+
+template <OneDimRealBaseType Base>
+STRICT_NODISCARD index_t count_unique(const Base& A) {
+   const long int n = A.size().val();
+   const long int nchunks = internal::chunk_count(n, internal::sort_chunk);
+   std::vector<long int> count(static_cast<std::size_t>(nchunks));
+   internal::with_reader(A, [&](auto a) {
+      internal::parallel_for_range(n, internal::sort_chunk, [&](long int first, long int last) {
+         const long int c = first / internal::sort_chunk;
+         long int k = 0;
+         for(long int i = first; i < last; ++i) {
+            k += i == 0 || internal::search_at(a, i) != internal::search_at(a, i - 1);
+         }
+         count[static_cast<std::size_t>(c)] = k;
+      });
+   });
+   long int k = 0;
+   for(auto x : count) {
+      k += x;
+   }
+   return index_t{k};
+}
+
+
+// elements that are in A or B; element that occurs m times in A and n times in B occurs max(m, n) times
+template <OneDimRealBaseType Base1, OneDimRealBaseType Base2>
+   requires SameAs<BuiltinTypeOf<Base1>, BuiltinTypeOf<Base2>>
+STRICT_NODISCARD auto set_union(const Base1& A, const Base2& B) {
+   return internal::set_operation<internal::SetUnion>(A, B);
+}
+
+
+// elements that are in A and B; element that occurs m times in A and n times in B occurs min(m, n) times
+template <OneDimRealBaseType Base1, OneDimRealBaseType Base2>
+   requires SameAs<BuiltinTypeOf<Base1>, BuiltinTypeOf<Base2>>
+STRICT_NODISCARD auto set_intersection(const Base1& A, const Base2& B) {
+   return internal::set_operation<internal::SetIntersection>(A, B);
+}
+
+
+// elements of A that are not in B; element that occurs m times in A and n times in B occurs
+// max(m - n, 0) times
+template <OneDimRealBaseType Base1, OneDimRealBaseType Base2>
+   requires SameAs<BuiltinTypeOf<Base1>, BuiltinTypeOf<Base2>>
+STRICT_NODISCARD auto set_difference(const Base1& A, const Base2& B) {
+   return internal::set_operation<internal::SetDifference>(A, B);
 }
 
 
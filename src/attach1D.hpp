@@ -6,6 +6,11 @@
 #pragma once
 
 
+#include <functional>  // function
+#include <memory>      // unique_ptr, make_unique
+#include <utility>     // move
+#include <vector>      // vector
+
 #include "derived1D.hpp"
 
 
@@ -80,5 +85,59 @@ STRICT_NODISCARD auto attach1D(const T* data, ImplicitInt n) {
 }
 
 
+// attaches n elements data[0], data[stride], ..., data[(n - 1) * stride]
+// stride is allowed to be negative or zero
+template <Builtin T>
+STRICT_NODISCARD auto attach1D(T* data, ImplicitInt n, Stride stride) {
+   ASSERT_STRICT_DEBUG(n.get() > -1_sl);
+   auto s = stride.get();
+   auto extent = n.get() != 0_sl ? (n.get() - 1_sl) * abss(s) + 1_sl : 0_sl;
+   // proxy starts at the element with the lowest address
+   auto first = s < 0_sl ? extent - 1_sl : 0_sl;
+   auto proxy = strict_attach_ptr1D(data - first.val(), extent);
+   return Derived1D<SliceArrayBase1D<decltype(proxy)>>{proxy, seqN{first, n, s}};
+}
+
+
+template <Builtin T>
+STRICT_NODISCARD auto attach1D(const T* data, ImplicitInt n, Stride stride) {
+   ASSERT_STRICT_DEBUG(n.get() > -1_sl);
+   auto s = stride.get();
+   auto extent = n.get() != 0_sl ? (n.get() - 1_sl) * abss(s) + 1_sl : 0_sl;
+   auto first = s < 0_sl ? extent - 1_sl : 0_sl;
+   auto proxy = const_strict_attach_ptr1D(data - first.val(), extent);
+   return Derived1D<ConstSliceArrayBase1D<decltype(proxy)>>{proxy, seqN{first, n, s}};
+}
+
+
+// Unlike attach1D, returns an array that owns data and calls deleter(data) once it no longer needs it.
+// Resizing works as usual: data is released after elements are copied to the new storage.
+template <Builtin T, AlignmentFlag AF = Aligned>
+STRICT_NODISCARD auto adopt1D(T* data, ImplicitInt n, std::function<void(T*)> deleter) {
+   return Array1D<T, AF>(internal::Adopt{}, data, n, std::move(deleter));
+}
+
+
+// can be used for the value returned by release
+template <Builtin T, AlignmentFlag AF = Aligned, typename D>
+STRICT_NODISCARD auto adopt1D(std::unique_ptr<T[], D>&& data, ImplicitInt n) {
+   auto A = adopt1D<T, AF>(data.get(), n, [d = data.get_deleter()](T* p) mutable { d(p); });
+   (void)data.release();
+   return A;
+}
+
+
+// elements of v are not copied
+template <Builtin T, AlignmentFlag AF = Aligned>
+   requires(!SameAs<T, bool>)
+STRICT_NODISCARD auto adopt1D(std::vector<T>&& v) {
+   auto owner = std::make_unique<std::vector<T>>(std::move(v));
+   auto* p = owner.get();
+   auto A = adopt1D<T, AF>(p->data(), from_size_t<long int>(p->size()), [p](T*) { delete p; });
+   (void)owner.release();
+   return A;
+}
+
+
 }  // namespace slib
 
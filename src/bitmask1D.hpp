@@ -0,0 +1,347 @@
+//  Copyright (C) 2024 Arkadijs Slobodkins - All Rights Reserved
+// License is 3-clause BSD:
+// https://github.com/arkslobodkins/strict-lib
+
+
+#pragma once
+
+
+#include <algorithm>  // all_of, any_of, fill, min
+#include <bit>        // countr_zero, popcount
+#include <cstdint>    // uint64_t
+#include <utility>    // swap
+#include <vector>     // vector
+
+#include "Common/common.hpp"
+#include "Expr/array_expr1D.hpp"
+#include "derived1D.hpp"
+
+
+// Boolean arrays stored with one bit per element. BitMask1D can be used wherever
+// one-dimensional boolean expressions are used and can be constructed from them, e.g.
+// BitMask1D M = (A > x) && (A < y). Bits past the last element are always zero, so that
+// count, any, all, and logical operations work on whole 64-bit words.
+namespace slib {
+
+
+class STRICT_NODISCARD BitMask1D : private ReferenceBase1D {
+public:
+   using value_type = StrictBool;
+   using builtin_type = bool;
+   using word_type = std::uint64_t;
+
+   static constexpr long int word_bits = 64;
+
+   // returned by non-constant operator[]
+   class Reference {
+   public:
+      Reference& operator=(value_type x) {
+         M_.set(i_, x);
+         return *this;
+      }
+
+      Reference& operator=(const Reference& r) {
+         return *this = r.M_.index(r.i_);
+      }
+
+      operator value_type() const {
+         return M_.index(i_);
+      }
+
+      STRICT_NODISCARD bool val() const {
+         return M_.index(i_).val();
+      }
+
+   private:
+      friend class BitMask1D;
+
+      Reference(BitMask1D& M, long int i) : M_{M}, i_{i} {
+      }
+
+      BitMask1D& M_;
+      long int i_;
+   };
+
+   // constructors
+   STRICT_NODISCARD explicit BitMask1D() : n_{0_sl} {
+   }
+
+   STRICT_NODISCARD explicit BitMask1D(ImplicitInt n, value_type x = false_sb)
+       : n_{n.get()},
+         words_(static_cast<std::size_t>(word_count(n.get().val())), x.val() ? ~word_type{0} : word_type{0}) {
+      ASSERT_STRICT_DEBUG(n_ > -1_sl);
+      this->clear_tail();
+   }
+
+   // elements at indexes are set, all other elements are cleared
+   STRICT_NODISCARD explicit BitMask1D(ImplicitInt n, const std::vector<ImplicitInt>& indexes) : BitMask1D(n) {
+      for(auto i : indexes) {
+         ASSERT_STRICT_DEBUG(internal::valid_index(*this, i.get()));
+         const long int iv = i.get().val();
+         words_[static_cast<std::size_t>(iv / word_bits)] |= word_type{1} << (iv % word_bits);
+      }
+   }
+
+   // packs 64 elements of A into each word; words are packed in parallel
+   template <OneDimBooleanBaseType Base>
+   STRICT_NODISCARD BitMask1D(const Base& A)
+       : n_{A.size()},
+         words_(static_cast<std::size_t>(word_count(A.size().val()))) {
+      const long int n = n_.val();
+      this->for_words([&](long int first, long int last) {
+         for(long int k = first; k < last; ++k) {
+            const long int i = k * word_bits;
+            const long int m = std::min(word_bits, n - i);
+            word_type w = 0;
+            for(long int j = 0; j < m; ++j) {
+               w |= word_type{A.index(i + j).val()} << j;
+            }
+            words_[static_cast<std::size_t>(k)] = w;
+         }
+      });
+   }
+
+   STRICT_NODISCARD BitMask1D(const BitMask1D&) = default;
+   STRICT_NODISCARD BitMask1D(BitMask1D&&) noexcept = default;
+
+   // assignments
+   BitMask1D& operator=(const BitMask1D&) = default;
+   BitMask1D& operator=(BitMask1D&&) noexcept = default;
+
+   // A is evaluated before assignment, so that it can refer to this mask
+   template <OneDimBooleanBaseType Base>
+   BitMask1D& operator=(const Base& A) {
+      ASSERT_STRICT_DEBUG(same_size(*this, A));
+      BitMask1D M{A};
+      this->swap(M);
+      return *this;
+   }
+
+   BitMask1D& operator=(value_type x) {
+      std::fill(words_.begin(), words_.end(), x.val() ? ~word_type{0} : word_type{0});
+      this->clear_tail();
+      return *this;
+   }
+
+   void swap(BitMask1D& M) noexcept {
+      std::swap(n_, M.n_);
+      words_.swap(M.words_);
+   }
+
+   STRICT_NODISCARD_INLINE index_t size() const {
+      return n_;
+   }
+
+   STRICT_NODISCARD_INLINE StrictBool empty() const {
+      return n_ == 0_sl;
+   }
+
+   STRICT_NODISCARD_INLINE value_type index(ImplicitInt i) const {
+      const long int iv = i.get().val();
+      return StrictBool{static_cast<bool>((words_[static_cast<std::size_t>(iv / word_bits)] >> (iv % word_bits)) & 1)};
+   }
+
+   STRICT_NODISCARD_INLINE value_type operator[](ImplicitInt i) const {
+      ASSERT_STRICT_DEBUG(internal::valid_index(*this, i.get()));
+      return this->index(i);
+   }
+
+   STRICT_NODISCARD_INLINE Reference operator[](ImplicitInt i) {
+      ASSERT_STRICT_DEBUG(internal::valid_index(*this, i.get()));
+      return Reference{*this, i.get().val()};
+   }
+
+   // sets element i without branches
+   STRICT_INLINE void set(ImplicitInt i, value_type x) {
+      const long int iv = i.get().val();
+      auto& w = words_[static_cast<std::size_t>(iv / word_bits)];
+      const word_type bit = word_type{1} << (iv % word_bits);
+      w = (w & ~bit) | ((word_type{0} - word_type{x.val()}) & bit);
+   }
+
+   STRICT_NODISCARD index_t word_count() const {
+      return from_size_t<long int>(words_.size());
+   }
+
+   STRICT_NODISCARD const word_type* words() const {
+      return words_.data();
+   }
+
+   // logical operations on whole words
+   BitMask1D& operator&=(const BitMask1D& M) {
+      ASSERT_STRICT_DEBUG(same_size(*this, M));
+      this->for_words([&](long int first, long int last) {
+         for(auto k = static_cast<std::size_t>(first); k < static_cast<std::size_t>(last); ++k) {
+            words_[k] &= M.words_[k];
+         }
+      });
+      return *this;
+   }
+
+   BitMask1D& operator|=(const BitMask1D& M) {
+      ASSERT_STRICT_DEBUG(same_size(*this, M));
+      this->for_words([&](long int first, long int last) {
+         for(auto k = static_cast<std::size_t>(first); k < static_cast<std::size_t>(last); ++k) {
+            words_[k] |= M.words_[k];
+         }
+      });
+      return *this;
+   }
+
+   BitMask1D& operator^=(const BitMask1D& M) {
+      ASSERT_STRICT_DEBUG(same_size(*this, M));
+      this->for_words([&](long int first, long int last) {
+         for(auto k = static_cast<std::size_t>(first); k < static_cast<std::size_t>(last); ++k) {
+            words_[k] ^= M.words_[k];
+         }
+      });
+      return *this;
+   }
+
+   BitMask1D& flip() {
+      this->for_words([&](long int first, long int last) {
+         for(auto k = static_cast<std::size_t>(first); k < static_cast<std::size_t>(last); ++k) {
+            words_[k] = ~words_[k];
+         }
+      });
+      this->clear_tail();
+      return *this;
+   }
+
+   STRICT_NODISCARD index_t count() const {
+      const long int nw = this->word_count().val();
+      const long int nchunks = internal::chunk_count(nw, chunk_words);
+      std::vector<long int> k(static_cast<std::size_t>(nchunks));
+      this->for_words([&](long int first, long int last) {
+         long int s = 0;
+         for(auto j = static_cast<std::size_t>(first); j < static_cast<std::size_t>(last); ++j) {
+            s += std::popcount(words_[j]);
+         }
+         k[static_cast<std::size_t>(first / chunk_words)] = s;
+      });
+      long int total = 0;
+      for(auto s : k) {
+         total += s;
+      }
+      return index_t{total};
+   }
+
+   // indexes of set elements in increasing order, written in parallel to offsets
+   // found by the prefix sum of popcounts of chunks
+   STRICT_NODISCARD std::vector<ImplicitInt> indexes() const {
+      const long int nw = this->word_count().val();
+      const long int nchunks = internal::chunk_count(nw, chunk_words);
+      std::vector<long int> offset(static_cast<std::size_t>(nchunks + 1));
+      this->for_words([&](long int first, long int last) {
+         long int s = 0;
+         for(auto j = static_cast<std::size_t>(first); j < static_cast<std::size_t>(last); ++j) {
+            s += std::popcount(words_[j]);
+         }
+         offset[static_cast<std::size_t>(first / chunk_words + 1)] = s;
+      });
+      for(std::size_t c = 0; c < static_cast<std::size_t>(nchunks); ++c) {
+         offset[c + 1] += offset[c];
+      }
+
+      std::vector<ImplicitInt> r(static_cast<std::size_t>(offset.back()));
+      this->for_words([&](long int first, long int last) {
+         auto p = static_cast<std::size_t>(offset[static_cast<std::size_t>(first / chunk_words)]);
+         for(long int j = first; j < last; ++j) {
+            for(word_type w = words_[static_cast<std::size_t>(j)]; w != 0; w &= w - 1) {
+               r[p++] = j * word_bits + std::countr_zero(w);
+            }
+         }
+      });
+      return r;
+   }
+
+private:
+   index_t n_;
+   std::vector<word_type> words_;
+
+   // number of words processed by one task
+   static constexpr long int chunk_words = internal::parallel_threshold / word_bits;
+
+   static constexpr long int word_count(long int n) {
+      return (n + word_bits - 1) / word_bits;
+   }
+
+   void clear_tail() {
+      if(const long int r = n_.val() % word_bits; r != 0) {
+         words_.back() &= (word_type{1} << r) - 1;
+      }
+   }
+
+   // calls f(first, last) for chunks of words in parallel
+   template <typename F>
+   void for_words(F f) const {
+      const long int nw = static_cast<long int>(words_.size());
+      internal::parallel_for_range(nw, chunk_words, f);
+   }
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+STRICT_NODISCARD_INLINE BitMask1D operator&(BitMask1D M1, const BitMask1D& M2) {
+   M1 &= M2;
+   return M1;
+}
+
+
+STRICT_NODISCARD_INLINE BitMask1D operator|(BitMask1D M1, const BitMask1D& M2) {
+   M1 |= M2;
+   return M1;
+}
+
+
+STRICT_NODISCARD_INLINE BitMask1D operator^(BitMask1D M1, const BitMask1D& M2) {
+   M1 ^= M2;
+   return M1;
+}
+
+
+STRICT_NODISCARD_INLINE BitMask1D operator~(BitMask1D M) {
+   M.flip();
+   return M;
+}
+
+
+// overloads of reductions of boolean expressions that operate on words
+STRICT_NODISCARD_INLINE index_t count(const BitMask1D& M) {
+   return M.count();
+}
+
+
+STRICT_NODISCARD_INLINE StrictBool any(const BitMask1D& M) {
+   const auto* w = M.words();
+   const long int nw = M.word_count().val();
+   return StrictBool{std::any_of(w, w + nw, [](BitMask1D::word_type x) { return x != 0; })};
+}
+
+
+STRICT_NODISCARD_INLINE StrictBool all(const BitMask1D& M) {
+   const auto* w = M.words();
+   const long int nw = M.word_count().val();
+   if(nw == 0) {
+      return true_sb;
+   }
+   if(!std::all_of(w, w + nw - 1, [](BitMask1D::word_type x) { return x == ~BitMask1D::word_type{0}; })) {
+      return false_sb;
+   }
+   const long int r = M.size().val() % BitMask1D::word_bits;
+   const auto last = r == 0 ? ~BitMask1D::word_type{0} : (BitMask1D::word_type{1} << r) - 1;
+   return StrictBool{w[nw - 1] == last};
+}
+
+
+// A is allowed to be empty
+// returns a slice array of all elements of A whose elements in M are set
+template <typename Base>
+   requires(OneDimBaseType<RemoveRef<Base>> && !ArrayOneDimTypeRvalue<Base>)
+STRICT_NODISCARD auto in_mask(Base&& A, const BitMask1D& M) {
+   ASSERT_STRICT_DEBUG(same_size(A, M));
+   return A(M.indexes());
+}
+
+
+}  // namespace slib
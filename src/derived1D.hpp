@@ -14,6 +14,7 @@
 #include "array_base1D.hpp"
 #include "fixed_array_base1D.hpp"
 #include "iterator.hpp"
+#include "shared_array_base1D.hpp"
 #include "slicearray_base1D.hpp"
 
 
@@ -24,11 +25,18 @@ template <OneDimBaseType Base>
 class Derived1D;
 
 
-template <typename D> concept ArrayOneDimType = FixedArray1DType<D> || Array1DType<D>;
+class BitMask1D;
+
+
+template <typename D> concept BitMask1DType = SameAs<RemoveCVRef<D>, BitMask1D>;
+
+template <typename D> concept ArrayOneDimType = FixedArray1DType<D> || Array1DType<D> || SharedArray1DType<D>;
 
 template <typename D> concept ArrayOneDimRealType = ArrayOneDimType<D> && OneDimRealBaseType<D>;
 
-template <typename D> concept ArrayOneDimTypeRvalue = ArrayOneDimType<D> && !std::is_lvalue_reference_v<D>;
+// masks are not strided arrays, but they own their elements, so their rvalues are rejected as well
+template <typename D> concept ArrayOneDimTypeRvalue
+    = (ArrayOneDimType<D> || BitMask1DType<D>) && !std::is_lvalue_reference_v<D>;
 
 template <typename D> concept ArrayOneDimRealTypeRvalue
     = ArrayOneDimRealType<D> && !std::is_lvalue_reference_v<D>;
@@ -46,6 +54,9 @@ template <typename D> concept ArrayOneDimIntegerTypeRvalueWith
 template <typename D> concept ArrayOneDimFloatTypeRvalueWith
     = OneDimFloatingBaseType<RemoveRef<D>> && ArrayOneDimRealTypeRvalue<D>;
 
+template <typename D> concept ArrayOneDimBooleanTypeRvalueWith
+    = OneDimBooleanBaseType<RemoveRef<D>> && ArrayOneDimTypeRvalue<D>;
+
 
 template <OneDimBaseType Base>
 class STRICT_NODISCARD Derived1D final : public Base {
@@ -968,4 +979,10 @@ template <Builtin T, ImplicitIntStatic sz>
 using FixedArray1D = Derived1D<FixedArrayBase1D<T, sz>>;
 
 
+#ifdef STRICT_SHARED_MEMORY
+template <Builtin T, SharedAccessFlag SAF = ReadWrite>
+using SharedArray1D = Derived1D<SharedArrayBase1D<T, SAF>>;
+#endif
+
+
 }  // namespace slib
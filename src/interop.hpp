@@ -0,0 +1,198 @@
+//  Copyright (C) 2024 Arkadijs Slobodkins - All Rights Reserved
+// License is 3-clause BSD:
+// https://github.com/arkslobodkins/strict-lib
+
+
+#pragma once
+
+
+#include <span>         // span, dynamic_extent
+#include <type_traits>  // conditional_t, is_const_v, remove_reference_t
+#include <utility>      // pair
+
+#include "Common/common.hpp"
+#include "attach1D.hpp"
+#include "derived1D.hpp"
+
+#ifdef __cpp_lib_mdspan
+#include <array>   // array
+#include <mdspan>  // mdspan, dextents, layout_stride
+#endif
+
+#ifdef STRICT_EIGEN
+#if __has_include(<Eigen/Core>)
+#include <Eigen/Core>
+#else
+#error EIGEN IS NOT AVAILABLE. COMPILE WITHOUT STRICT_EIGEN OR ADD EIGEN TO THE INCLUDE PATH.
+#endif
+#endif
+
+
+// Zero-copy conversions between one-dimensional arrays and std::span, std::mdspan(C++23), and
+// Eigen::Map(if STRICT_EIGEN is defined). Arrays and linear slices of arrays, as well as arrays
+// attached with attach1D, are stored with a constant stride and can be viewed by other libraries.
+// Conversely, memory owned by other libraries can be viewed as one-dimensional array by attach1D.
+namespace slib {
+
+
+namespace internal {
+
+
+template <typename T>
+struct StridedStorage {
+   static constexpr bool value = ArrayOneDimType<T>;
+};
+
+
+template <Builtin T>
+struct StridedStorage<strict_attach_ptr1D<T>> {
+   static constexpr bool value = true;
+};
+
+
+template <Builtin T>
+struct StridedStorage<const_strict_attach_ptr1D<T>> {
+   static constexpr bool value = true;
+};
+
+
+template <typename Base>
+struct StridedStorage<Derived1D<SliceArrayBase1D<Base>>> {
+   static constexpr bool value = StridedStorage<Base>::value;
+};
+
+
+template <typename Base>
+struct StridedStorage<Derived1D<ConstSliceArrayBase1D<Base>>> {
+   static constexpr bool value = StridedStorage<Base>::value;
+};
+
+
+}  // namespace internal
+
+
+// one-dimensional types whose elements are stored in memory with a constant stride
+template <typename T> concept StridedOneDimType
+    = OneDimBaseType<T> && internal::StridedStorage<std::remove_const_t<T>>::value;
+
+
+namespace internal {
+
+
+// element type with constness of the elements of A
+template <typename Base>
+using StridedElement
+    = std::conditional_t<std::is_const_v<std::remove_reference_t<decltype(std::declval<Base&>().index(0))>>,
+                         const BuiltinTypeOf<Base>, BuiltinTypeOf<Base>>;
+
+
+// returns pointer to the first element and distance between consecutive elements
+template <StridedOneDimType Base>
+STRICT_NODISCARD std::pair<StridedElement<Base>*, long int> strided_data(Base& A) {
+   if(A.empty()) {
+      return {nullptr, 1};
+   }
+
+   auto* first = reinterpret_cast<StridedElement<Base>*>(&A.index(0));
+   if(A.size() == 1_sl) {
+      return {first, 1};
+   }
+   return {first, &A.index(1) - &A.index(0)};
+}
+
+
+}  // namespace internal
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// temporary arrays are not allowed to reduce the risk of dangling references
+// A must be stored contiguously, i.e. stride is 1
+template <typename Base>
+   requires(StridedOneDimType<RemoveRef<Base>> && !ArrayOneDimTypeRvalue<Base>)
+STRICT_NODISCARD auto span1D(Base&& A) {
+   auto [data, stride] = internal::strided_data(A);
+   ASSERT_STRICT_DEBUG(stride == 1);
+   return std::span<internal::StridedElement<RemoveRef<Base>>>{data, to_size_t(A.size())};
+}
+
+
+template <Builtin T>
+STRICT_NODISCARD auto attach1D(std::span<T> s) {
+   return attach1D(s.data(), from_size_t<long int>(s.size()));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef __cpp_lib_mdspan
+
+
+// stride of A must be positive
+template <typename Base>
+   requires(StridedOneDimType<RemoveRef<Base>> && !ArrayOneDimTypeRvalue<Base>)
+STRICT_NODISCARD auto mdspan1D(Base&& A) {
+   using T = internal::StridedElement<RemoveRef<Base>>;
+   using extents_type = std::dextents<long int, 1>;
+
+   auto [data, stride] = internal::strided_data(A);
+   ASSERT_STRICT_DEBUG(stride > 0);
+   auto mapping = std::layout_stride::mapping<extents_type>{extents_type{A.size().val()},
+                                                             std::array<long int, 1>{stride}};
+   return std::mdspan<T, extents_type, std::layout_stride>{data, mapping};
+}
+
+
+template <Builtin T, typename Extents, typename Layout, typename Accessor>
+   requires(Extents::rank() == 1)
+STRICT_NODISCARD auto attach1D(std::mdspan<T, Extents, Layout, Accessor> s) {
+   return attach1D(s.data_handle(), static_cast<long int>(s.extent(0)),
+                   Stride{static_cast<long int>(s.stride(0))});
+}
+
+
+#endif
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef STRICT_EIGEN
+
+
+// stride of A must be positive
+template <typename Base>
+   requires(StridedOneDimType<RemoveRef<Base>> && !ArrayOneDimTypeRvalue<Base>)
+STRICT_NODISCARD auto eigen_map(Base&& A) {
+   using T = internal::StridedElement<RemoveRef<Base>>;
+   using eigen_array = Eigen::Array<std::remove_const_t<T>, Eigen::Dynamic, 1>;
+   using map_type
+       = Eigen::Map<std::conditional_t<std::is_const_v<T>, const eigen_array, eigen_array>, Eigen::Unaligned,
+                    Eigen::InnerStride<>>;
+
+   auto [data, stride] = internal::strided_data(A);
+   ASSERT_STRICT_DEBUG(stride > 0);
+   return map_type{data, A.size().val(), Eigen::InnerStride<>{stride}};
+}
+
+
+// x must be a vector(one of the dimensions is 1) with direct access to its elements,
+// e.g. Eigen::ArrayXd, Eigen::VectorXd, or Eigen::Map
+template <typename Derived>
+   requires(Derived::IsVectorAtCompileTime != 0
+            && (Eigen::internal::traits<Derived>::Flags & Eigen::DirectAccessBit) != 0)
+STRICT_NODISCARD auto attach1D(Eigen::DenseBase<Derived>& x) {
+   auto& d = x.derived();
+   return attach1D(d.data(), static_cast<long int>(d.size()), Stride{static_cast<long int>(d.innerStride())});
+}
+
+
+template <typename Derived>
+   requires(Derived::IsVectorAtCompileTime != 0
+            && (Eigen::internal::traits<Derived>::Flags & Eigen::DirectAccessBit) != 0)
+STRICT_NODISCARD auto attach1D(const Eigen::DenseBase<Derived>& x) {
+   const auto& d = x.derived();
+   return attach1D(d.data(), static_cast<long int>(d.size()), Stride{static_cast<long int>(d.innerStride())});
+}
+
+
+#endif
+
+
+}  // namespace slib
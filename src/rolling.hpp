@@ -0,0 +1,289 @@
+//  Copyright (C) 2024 Arkadijs Slobodkins - All Rights Reserved
+// License is 3-clause BSD:
+// https://github.com/arkslobodkins/strict-lib
+
+
+#pragma once
+
+
+#include <algorithm>   // min
+#include <functional>  // greater, less
+#include <vector>      // vector
+
+#include "Common/common.hpp"
+#include "Expr/array_expr1D.hpp"
+#include "derived1D.hpp"
+
+
+// Statistics of sliding windows of one-dimensional arrays and expressions. Element i of the
+// result refers to the window A[i], ..., A[i + w - 1], so that the result has A.size() - w + 1
+// elements. Windows are computed in O(n) time: sums are updated as the window slides, and
+// minimums and maximums are found using monotonic queues. Small windows are instead computed
+// directly, in loops that vectorize. Long arrays are split into chunks that are processed in
+// parallel, where every chunk also reads the w - 1 elements that follow it. Since running
+// updates restart at every chunk, rounding errors do not accumulate over the whole array.
+namespace slib {
+
+
+namespace internal {
+
+
+// number of windows processed by one task
+static constexpr inline long int rolling_chunk = parallel_threshold;
+
+
+// windows of at most this size are computed directly; variances take two passes
+static constexpr inline long int small_window = 16;
+static constexpr inline long int small_var_window = small_window / 2;
+
+
+// calls f(first, last) for chunks of windows in parallel
+template <OneDimRealBaseType Base, typename F>
+Array1D<RealTypeOf<Base>> rolling(const Base& A, long int w, F f) {
+   ASSERT_STRICT_DEBUG(w > 0);
+   ASSERT_STRICT_DEBUG(w <= A.size().val());
+   const long int m = A.size().val() - w + 1;
+   Array1D<RealTypeOf<Base>> R(m);
+   parallel_for_range(m, rolling_chunk, [&](long int first, long int last) { f(R, first, last); });
+   return R;
+}
+
+
+// R[i] = op(A[i], ..., A[i + w - 1]) for windows first, ..., last - 1; the inner
+// loop runs over windows, so that it vectorizes
+template <typename Base, typename Out, typename Op>
+void direct_range(const Base& A, Out& R, long int w, long int first, long int last, Op op) {
+   for(long int i = first; i < last; ++i) {
+      R.index(i) = A.index(i);
+   }
+   for(long int j = 1; j < w; ++j) {
+      for(long int i = first; i < last; ++i) {
+         R.index(i) = op(R.index(i), A.index(i + j));
+      }
+   }
+}
+
+
+// floating-point sums are compensated, as in Neumaier's algorithm
+template <typename Base, typename Out>
+void running_sum_range(const Base& A, Out& R, long int w, long int first, long int last) {
+   using T = ValueTypeOf<Base>;
+   T s{}, e{};
+   auto add = [&s, &e](T x) {
+      if constexpr(Floating<BuiltinTypeOf<Base>>) {
+         const T t = s + x;
+         e += abss(s) >= abss(x) ? (s - t) + x : (x - t) + s;
+         s = t;
+      } else {
+         s += x;
+      }
+   };
+
+   for(long int j = 0; j < w; ++j) {
+      add(A.index(first + j));
+   }
+   R.index(first) = s + e;
+   // negation is not available for unsigned types
+   auto remove = [&s, &add](T x) {
+      if constexpr(Floating<BuiltinTypeOf<Base>>) {
+         add(-x);
+      } else {
+         s -= x;
+      }
+   };
+
+   for(long int i = first + 1; i < last; ++i) {
+      add(A.index(i + w - 1));
+      remove(A.index(i - 1));
+      R.index(i) = s + e;
+   }
+}
+
+
+template <typename Base, typename Out>
+void sum_range(const Base& A, Out& R, long int w, long int first, long int last) {
+   if(w <= small_window) {
+      direct_range(A, R, w, first, last, BinaryPlus{});
+   } else {
+      running_sum_range(A, R, w, first, last);
+   }
+}
+
+
+// the queue holds windows' candidates for the best element in increasing order of
+// indexes; elements that are not better than a new element are removed from its back
+template <typename Base, typename Out, typename Better>
+void monotonic_range(const Base& A, Out& R, long int w, long int first, long int last, Better better) {
+   using T = ValueTypeOf<Base>;
+   std::vector<T> values(static_cast<std::size_t>(last - first + w - 1));
+   std::vector<long int> indexes(values.size());
+   std::size_t head = 0, tail = 0;
+
+   for(long int i = first; i < last + w - 1; ++i) {
+      const T x = A.index(i);
+      while(tail > head && !better(values[tail - 1], x)) {
+         --tail;
+      }
+      values[tail] = x;
+      indexes[tail++] = i;
+      if(const long int k = i - w + 1; k >= first) {
+         if(indexes[head] < k) {
+            ++head;
+         }
+         R.index(k) = values[head];
+      }
+   }
+}
+
+
+// best of two values, where NaNs are better than all other values, so that windows that contain
+// NaNs give NaN. Builtin values are compared, which lets the loops of direct_range vectorize.
+template <typename Better>
+struct NanBest {
+   template <Real T>
+   STRICT_CONSTEXPR static bool keeps(T x, T y) {
+      if constexpr(Floating<T>) {
+         return Better{}(x, y) | (x != x);
+      } else {
+         return Better{}(x, y);
+      }
+   }
+
+   template <Real T>
+   STRICT_CONSTEXPR Strict<T> operator()(Strict<T> x, Strict<T> y) const {
+      return Strict<T>{keeps(x.val(), y.val()) ? x.val() : y.val()};
+   }
+};
+
+
+template <typename Base, typename Out, typename Better>
+void extreme_range(const Base& A, Out& R, long int w, long int first, long int last, NanBest<Better> best) {
+   if(w <= small_window) {
+      direct_range(A, R, w, first, last, best);
+   } else {
+      monotonic_range(A, R, w, first, last, [best](auto x, auto y) { return best.keeps(x.val(), y.val()); });
+   }
+}
+
+
+// sample variances; small windows are computed in two passes, and larger windows are updated
+// as the window slides using the update of Welford's algorithm for replaced elements
+template <typename Base, typename Out>
+void var_range(const Base& A, Out& R, long int w, long int first, long int last) {
+   using T = ValueTypeOf<Base>;
+   const T wt = value_type_cast<Base>(index_t{w});
+   const T wt1 = value_type_cast<Base>(index_t{w - 1});
+   const T zero{};
+
+   if(w <= small_var_window) {
+      std::vector<T> mean(static_cast<std::size_t>(last - first));
+      for(long int i = first; i < last; ++i) {
+         mean[static_cast<std::size_t>(i - first)] = A.index(i);
+      }
+      for(long int j = 1; j < w; ++j) {
+         for(long int i = first; i < last; ++i) {
+            mean[static_cast<std::size_t>(i - first)] += A.index(i + j);
+         }
+      }
+      for(long int i = first; i < last; ++i) {
+         mean[static_cast<std::size_t>(i - first)] /= wt;
+         R.index(i) = zero;
+      }
+      for(long int j = 0; j < w; ++j) {
+         for(long int i = first; i < last; ++i) {
+            const T d = A.index(i + j) - mean[static_cast<std::size_t>(i - first)];
+            R.index(i) += d * d;
+         }
+      }
+      for(long int i = first; i < last; ++i) {
+         R.index(i) /= wt1;
+      }
+      return;
+   }
+
+   T mean{}, m2{};
+   for(long int j = 0; j < w; ++j) {
+      const T x = A.index(first + j);
+      const T d = x - mean;
+      mean += d / value_type_cast<Base>(index_t{j + 1});
+      m2 += d * (x - mean);
+   }
+   R.index(first) = maxs(m2, zero) / wt1;
+   for(long int i = first + 1; i < last; ++i) {
+      const T x_old = A.index(i - 1);
+      const T x_new = A.index(i + w - 1);
+      const T mean_old = mean;
+      mean += (x_new - x_old) / wt;
+      m2 += (x_new - x_old) * (x_new - mean + x_old - mean_old);
+      R.index(i) = maxs(m2, zero) / wt1;
+   }
+}
+
+
+}  // namespace internal
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 0 < w <= A.size() for all rolling operations. rolling_min and rolling_max give NaN for windows
+// that contain NaNs.
+template <OneDimRealBaseType Base>
+STRICT_NODISCARD Array1D<RealTypeOf<Base>> rolling_sum(const Base& A, ImplicitInt w) {
+   const long int wv = w.get().val();
+   return internal::rolling(A, wv, [&A, wv](auto& R, long int first, long int last) {
+      internal::sum_range(A, R, wv, first, last);
+   });
+}
+
+
+template <OneDimFloatingBaseType Base>
+STRICT_NODISCARD Array1D<RealTypeOf<Base>> rolling_mean(const Base& A, ImplicitInt w) {
+   const long int wv = w.get().val();
+   const auto wt = value_type_cast<Base>(w.get());
+   return internal::rolling(A, wv, [&A, wv, wt](auto& R, long int first, long int last) {
+      internal::sum_range(A, R, wv, first, last);
+      for(long int i = first; i < last; ++i) {
+         R.index(i) /= wt;
+      }
+   });
+}
+
+
+template <OneDimRealBaseType Base>
+STRICT_NODISCARD Array1D<RealTypeOf<Base>> rolling_min(const Base& A, ImplicitInt w) {
+   const long int wv = w.get().val();
+   return internal::rolling(A, wv, [&A, wv](auto& R, long int first, long int last) {
+      internal::extreme_range(A, R, wv, first, last, internal::NanBest<std::less<>>{});
+   });
+}
+
+
+template <OneDimRealBaseType Base>
+STRICT_NODISCARD Array1D<RealTypeOf<Base>> rolling_max(const Base& A, ImplicitInt w) {
+   const long int wv = w.get().val();
+   return internal::rolling(A, wv, [&A, wv](auto& R, long int first, long int last) {
+      internal::extreme_range(A, R, wv, first, last, internal::NanBest<std::greater<>>{});
+   });
+}
+
+
+// sample variances, which are divided by w - 1; w > 1
+template <OneDimFloatingBaseType Base>
+STRICT_NODISCARD Array1D<RealTypeOf<Base>> rolling_var(const Base& A, ImplicitInt w) {
+   const long int wv = w.get().val();
+   ASSERT_STRICT_DEBUG(wv > 1);
+   return internal::rolling(A, wv, [&A, wv](auto& R, long int first, long int last) {
+      internal::var_range(A, R, wv, first, last);
+   });
+}
+
+
+// sample standard deviations; w > 1
+template <OneDimFloatingBaseType Base>
+STRICT_NODISCARD Array1D<RealTypeOf<Base>> rolling_stddev(const Base& A, ImplicitInt w) {
+   auto R = rolling_var(A, w);
+   R = sqrt(R);
+   return R;
+}
+
+
+}  // namespace slib
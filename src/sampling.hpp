@@ -0,0 +1,338 @@
+//  Copyright (C) 2024 Arkadijs Slobodkins - All Rights Reserved
+// License is 3-clause BSD:
+// https://github.com/arkslobodkins/strict-lib
+
+
+#pragma once
+
+
+#include <algorithm>      // min, sort
+#include <cmath>          // exp, floor, log
+#include <cstdint>        // uint64_t
+#include <limits>         // numeric_limits
+#include <unordered_set>  // unordered_set
+#include <utility>        // move, swap
+#include <vector>         // vector
+
+#include "Common/common.hpp"
+#include "Expr/array_expr1D.hpp"
+#include "Util/random.hpp"
+
+
+// Random sampling with O(k) memory, where k is the number of samples.
+// sample_indexes and sample use Floyd's algorithm and return indexes in increasing order.
+// Reservoir samples streams of unknown length(algorithm L of Li) and can be merged with other
+// reservoirs, so that very large inputs can be sampled in parallel.
+// AliasTable samples indexes with replacement according to weights(alias method of Walker and Vose).
+namespace slib {
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// k distinct indexes in [0, n), sorted in increasing order
+STRICT_NODISCARD_INLINE std::vector<ImplicitInt> sample_indexes(ImplicitInt n, ImplicitInt k, std::uint64_t seed) {
+   ASSERT_STRICT_DEBUG(k.get() >= 0_sl);
+   ASSERT_STRICT_DEBUG(k.get() <= n.get());
+
+   Philox4x32 g{seed};
+   const long int nv = n.get().val();
+   const long int kv = k.get().val();
+
+   std::unordered_set<long int> s;
+   s.reserve(to_size_t(k.get()));
+   for(long int j = nv - kv; j < nv; ++j) {
+      if(const auto t = internal::uniform_int(g, 0L, j); !s.insert(t).second) {
+         s.insert(j);
+      }
+   }
+
+   std::vector<long int> v(s.begin(), s.end());
+   std::sort(v.begin(), v.end());
+   return std::vector<ImplicitInt>(v.begin(), v.end());
+}
+
+
+STRICT_NODISCARD_INLINE std::vector<ImplicitInt> sample_indexes(ImplicitInt n, ImplicitInt k) {
+   return sample_indexes(n, k, internal::thread_engine()());
+}
+
+
+// view of k distinct elements of A
+template <typename Base>
+   requires(OneDimBaseType<RemoveRef<Base>> && !ArrayOneDimTypeRvalue<Base>)
+STRICT_NODISCARD auto sample(Base&& A, ImplicitInt k, std::uint64_t seed) {
+   return A(sample_indexes(A.size(), k, seed));
+}
+
+
+template <typename Base>
+   requires(OneDimBaseType<RemoveRef<Base>> && !ArrayOneDimTypeRvalue<Base>)
+STRICT_NODISCARD auto sample(Base&& A, ImplicitInt k) {
+   return A(sample_indexes(A.size(), k));
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// uniform sample of k elements of a stream
+template <Builtin T>
+class Reservoir {
+public:
+   using value_type = Strict<T>;
+
+   explicit Reservoir(ImplicitInt k, std::uint64_t seed, std::uint64_t stream = 0)
+       : k_{k.get().val()},
+         count_{0},
+         next_{0},
+         w_{1.},
+         merged_{false},
+         g_{seed, stream} {
+      ASSERT_STRICT_DEBUG(k.get() > 0_sl);
+      // large samples grow as elements arrive, so that reservoirs of short streams stay small
+      values_.reserve(static_cast<std::size_t>(std::min(k_, internal::parallel_threshold)));
+   }
+
+   void push(value_type x) {
+      if(count_ < k_) {
+         values_.push_back(x);
+         if(count_ == k_ - 1) {
+            this->skip(count_);
+         }
+         ++count_;
+         return;
+      }
+      if(merged_) {
+         // state of algorithm L is not known after merge; x is sampled with probability k / (count + 1)
+         if(const auto j = internal::uniform_int(g_, 0L, count_); j < k_) {
+            values_[static_cast<std::size_t>(j)] = x;
+         }
+      } else if(count_ == next_) {
+         values_[static_cast<std::size_t>(internal::uniform_int(g_, 0L, k_ - 1))] = x;
+         this->skip(count_);
+      }
+      ++count_;
+   }
+
+   // combines samples of two disjoint streams; reservoirs must have the same capacity
+   void merge(Reservoir&& r) {
+      ASSERT_STRICT_DEBUG(k_ == r.k_);
+      const long int m = std::min(k_, count_ + r.count_);
+
+      // number of elements of the merged sample that come from this stream is hypergeometric
+      long int n1 = count_, n2 = r.count_, m1 = 0;
+      for(long int t = 0; t < m; ++t) {
+         if(internal::uniform_int(g_, 0L, n1 + n2 - 1) < n1) {
+            --n1;
+            ++m1;
+         } else {
+            --n2;
+         }
+      }
+
+      // uniform subsets of size m1 and m - m1 of both samples
+      partial_shuffle(values_, m1);
+      partial_shuffle(r.values_, m - m1);
+      values_.resize(static_cast<std::size_t>(m1));
+      values_.insert(values_.end(), r.values_.begin(), r.values_.begin() + (m - m1));
+
+      count_ += r.count_;
+      merged_ = values_.size() == static_cast<std::size_t>(k_);
+   }
+
+   STRICT_NODISCARD index_t count() const {
+      return index_t{count_};
+   }
+
+   STRICT_NODISCARD index_t size() const {
+      return from_size_t<long int>(values_.size());
+   }
+
+   STRICT_NODISCARD const std::vector<value_type>& values() const {
+      return values_;
+   }
+
+   STRICT_NODISCARD Array1D<T> array() const {
+      Array1D<T> A(this->size());
+      for(long int i = 0; i < A.size().val(); ++i) {
+         A.index(i) = values_[static_cast<std::size_t>(i)];
+      }
+      return A;
+   }
+
+private:
+   long int k_;
+   long int count_;
+   long int next_;  // index in the stream of the next element that enters the sample
+   double w_;
+   bool merged_;
+   Philox4x32 g_;
+   std::vector<value_type> values_;
+
+   double unit_not0() {
+      return 1. - internal::unit_real<double>(g_());
+   }
+
+   // i is the index in the stream of the element that last entered the sample
+   void skip(long int i) {
+      w_ *= std::exp(std::log(this->unit_not0()) / static_cast<double>(k_));
+      const double gap = std::floor(std::log(this->unit_not0()) / std::log1p(-w_));
+      next_ = gap < static_cast<double>(std::numeric_limits<long int>::max() - i - 1)
+                ? i + static_cast<long int>(gap) + 1
+                : std::numeric_limits<long int>::max();
+   }
+
+   // moves uniform subset of size m to the front of v
+   void partial_shuffle(std::vector<value_type>& v, long int m) {
+      const auto n = static_cast<long int>(v.size());
+      for(long int i = 0; i < m; ++i) {
+         const auto j = internal::uniform_int(g_, i, n - 1);
+         std::swap(v[static_cast<std::size_t>(i)], v[static_cast<std::size_t>(j)]);
+      }
+   }
+};
+
+
+// uniform sample of k elements of A computed by merging reservoirs of chunks of A in parallel;
+// suitable for expressions, whose elements are only evaluated once. Chunks are sampled in rounds
+// of one chunk per thread and merged after every round, so that O(threads * k) memory is used.
+template <OneDimBaseType Base>
+STRICT_NODISCARD auto reservoir_sample(const Base& A, ImplicitInt k, std::uint64_t seed) {
+   using T = BuiltinTypeOf<Base>;
+   constexpr long int chunk = internal::parallel_threshold;
+   const long int n = A.size().val();
+   const long int nchunks = internal::chunk_count(n, chunk);
+   const long int nthreads = internal::max_threads();
+
+   // chunks use streams 0, ..., nchunks - 1
+   Reservoir<T> sample{k, seed, static_cast<std::uint64_t>(nchunks)};
+   std::vector<Reservoir<T>> r;
+   for(long int c0 = 0; c0 < nchunks; c0 += nthreads) {
+      const long int m = std::min(nthreads, nchunks - c0);
+      r.clear();
+      for(long int c = c0; c < c0 + m; ++c) {
+         r.emplace_back(k, seed, static_cast<std::uint64_t>(c));
+      }
+
+      internal::parallel_for(m, [&](long int j) {
+         const long int first = (c0 + j) * chunk;
+         const long int last = std::min(n, first + chunk);
+         for(long int i = first; i < last; ++i) {
+            r[static_cast<std::size_t>(j)].push(A.index(i));
+         }
+      });
+
+      for(auto& rc : r) {
+         sample.merge(std::move(rc));
+      }
+   }
+   return sample.array();
+}
+
+
+template <OneDimBaseType Base>
+STRICT_NODISCARD auto reservoir_sample(const Base& A, ImplicitInt k) {
+   return reservoir_sample(A, k, internal::thread_engine()());
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// index i is sampled with probability weights[i] / sum(weights); weights must be non-negative
+// and at least one of them must be positive
+class AliasTable {
+public:
+   template <OneDimRealBaseType Base>
+   explicit AliasTable(const Base& weights) : prob_(weights.size()), alias_(weights.size()) {
+      ASSERT_STRICT_DEBUG(!weights.empty());
+      const long int n = weights.size().val();
+
+      double total = 0.;
+      for(long int i = 0; i < n; ++i) {
+         ASSERT_STRICT_DEBUG(weights.index(i) >= Zero<RealTypeOf<Base>>);
+         total += static_cast<double>(weights.index(i).val());
+      }
+      ASSERT_STRICT_DEBUG(total > 0.);
+
+      std::vector<long int> small, large;
+      for(long int i = 0; i < n; ++i) {
+         prob_.index(i) = Strict{static_cast<double>(weights.index(i).val()) * static_cast<double>(n) / total};
+         (prob_.index(i) < 1._sd ? small : large).push_back(i);
+      }
+
+      while(!small.empty() && !large.empty()) {
+         const long int s = small.back();
+         const long int l = large.back();
+         small.pop_back();
+         alias_.index(s) = Strict{l};
+         prob_.index(l) -= 1._sd - prob_.index(s);
+         if(prob_.index(l) < 1._sd) {
+            large.pop_back();
+            small.push_back(l);
+         }
+      }
+      // remaining probabilities are 1 up to rounding errors
+      for(auto i : large) {
+         prob_.index(i) = 1._sd;
+      }
+      for(auto i : small) {
+         prob_.index(i) = 1._sd;
+      }
+   }
+
+   STRICT_NODISCARD index_t size() const {
+      return prob_.size();
+   }
+
+   // g returns uniformly distributed 64-bit integers
+   template <typename G>
+   STRICT_NODISCARD index_t operator()(G& g) const {
+      const auto i = internal::uniform_int(g, 0L, prob_.size().val() - 1);
+      return Strict{internal::unit_real<double>(g())} < prob_.index(i) ? index_t{i} : alias_.index(i);
+   }
+
+private:
+   Array1D<double> prob_;
+   Array1D<long int> alias_;
+};
+
+
+// k indexes sampled with replacement according to weights; sample i is a pure function of seed and i,
+// so that samples are generated in parallel and do not depend on the number of threads
+template <OneDimRealBaseType Base>
+STRICT_NODISCARD std::vector<ImplicitInt> weighted_sample_indexes(const Base& weights, ImplicitInt k,
+                                                                  std::uint64_t seed) {
+   ASSERT_STRICT_DEBUG(k.get() >= 0_sl);
+   const AliasTable t{weights};
+   const RandomStream rs{seed};
+
+   std::vector<ImplicitInt> indexes(to_size_t(k.get()));
+   internal::parallel_for_range(k.get().val(), internal::random_chunk, [&](long int first, long int last) {
+      for(long int i = first; i < last; ++i) {
+         internal::ElementBits g{rs, static_cast<std::uint64_t>(i)};
+         indexes[static_cast<std::size_t>(i)] = t(g);
+      }
+   });
+   return indexes;
+}
+
+
+template <OneDimRealBaseType Base>
+STRICT_NODISCARD std::vector<ImplicitInt> weighted_sample_indexes(const Base& weights, ImplicitInt k) {
+   return weighted_sample_indexes(weights, k, internal::thread_engine()());
+}
+
+
+// view of k elements of A sampled with replacement according to weights
+template <typename Base1, OneDimRealBaseType Base2>
+   requires(OneDimBaseType<RemoveRef<Base1>> && !ArrayOneDimTypeRvalue<Base1>)
+STRICT_NODISCARD auto weighted_sample(Base1&& A, const Base2& weights, ImplicitInt k, std::uint64_t seed) {
+   ASSERT_STRICT_DEBUG(A.size() == weights.size());
+   return A(weighted_sample_indexes(weights, k, seed));
+}
+
+
+template <typename Base1, OneDimRealBaseType Base2>
+   requires(OneDimBaseType<RemoveRef<Base1>> && !ArrayOneDimTypeRvalue<Base1>)
+STRICT_NODISCARD auto weighted_sample(Base1&& A, const Base2& weights, ImplicitInt k) {
+   return weighted_sample(A, weights, k, internal::thread_engine()());
+}
+
+
+}  // namespace slib
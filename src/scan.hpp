@@ -0,0 +1,225 @@
+//  Copyright (C) 2024 Arkadijs Slobodkins - All Rights Reserved
+// License is 3-clause BSD:
+// https://github.com/arkslobodkins/strict-lib
+
+
+#pragma once
+
+
+#include <algorithm>  // min
+#include <concepts>   // invocable
+#include <utility>    // declval
+#include <vector>     // vector
+
+#include "Common/common.hpp"
+#include "Expr/array_expr1D.hpp"
+#include "derived1D.hpp"
+
+
+// Prefix sums and other scans of one-dimensional arrays and expressions.
+// Large inputs are scanned in two parallel passes: chunks are first reduced, the results of
+// chunks are scanned serially, and then every chunk is scanned starting from the result of
+// all previous chunks. Operations must therefore be associative, but they need not be
+// commutative, since elements are always combined in order. Elements of expressions are
+// evaluated twice. In-place scans can be applied to arrays, slices, and attached arrays.
+namespace slib {
+
+
+template <typename Base, typename Op> concept ScanOperation
+    = std::invocable<Op, ValueTypeOf<Base>, ValueTypeOf<Base>>
+   && SameAs<ValueTypeOf<Base>, decltype(std::declval<Op>()(ValueTypeOf<Base>{}, ValueTypeOf<Base>{}))>;
+
+
+template <typename Base> concept InPlaceScanType
+    = OneDimRealBaseType<RemoveRef<Base>> && NonConstBaseType<RemoveRef<Base>> && !IsConst<RemoveRef<Base>>
+   && !ArrayOneDimRealTypeRvalue<Base>;
+
+
+namespace internal {
+
+
+// number of elements processed by one task
+static constexpr inline long int scan_chunk = parallel_threshold;
+
+
+template <typename T, typename Get, typename Op>
+T reduce_range(long int first, long int last, Get get, Op op, T init) {
+   for(long int i = first; i < last; ++i) {
+      init = op(init, get(i));
+   }
+   return init;
+}
+
+
+// put(i, x) is called after get(i), so that get and put can refer to the same element
+template <typename T, typename Get, typename Put, typename Op>
+void scan_range(long int first, long int last, Get get, Put put, Op op, T carry, bool exclusive) {
+   if(exclusive) {
+      for(long int i = first; i < last; ++i) {
+         const T x = get(i);
+         put(i, carry);
+         carry = op(carry, x);
+      }
+   } else {
+      for(long int i = first; i < last; ++i) {
+         carry = op(carry, get(i));
+         put(i, carry);
+      }
+   }
+}
+
+
+// scan of elements first, ..., n - 1 that starts from init
+template <typename T, typename Get, typename Put, typename Op>
+void scan(long int first, long int n, Get get, Put put, Op op, T init, bool exclusive) {
+   const long int m = n - first;
+   if(m <= scan_chunk) {
+      scan_range(first, n, get, put, op, init, exclusive);
+      return;
+   }
+
+   const long int nchunks = chunk_count(m, scan_chunk);
+   auto chunk_first = [first](long int c) { return first + c * scan_chunk; };
+   auto chunk_last = [first, n](long int c) { return std::min(n, first + (c + 1) * scan_chunk); };
+
+   // the last chunk is not needed for carries
+   std::vector<T> carry(static_cast<std::size_t>(nchunks), init);
+   parallel_for(nchunks - 1, [&](long int c) {
+      const long int f = chunk_first(c);
+      carry[static_cast<std::size_t>(c + 1)] = reduce_range(f + 1, chunk_last(c), get, op, T{get(f)});
+   });
+   for(std::size_t c = 1; c < carry.size(); ++c) {
+      carry[c] = op(carry[c - 1], carry[c]);
+   }
+
+   parallel_for(nchunks, [&](long int c) {
+      scan_range(chunk_first(c), chunk_last(c), get, put, op, carry[static_cast<std::size_t>(c)], exclusive);
+   });
+}
+
+
+// element i of the result is op(A[0], ..., A[i]) for inclusive scans, and op(init, A[0], ..., A[i - 1])
+// for exclusive scans
+template <typename Base, typename Out, typename Op>
+void scan_into(const Base& A, Out& out, Op op, ValueTypeOf<Base> init, bool exclusive) {
+   using T = ValueTypeOf<Base>;
+   const long int n = A.size().val();
+   if(n == 0) {
+      return;
+   }
+   auto get = [&A](long int i) { return A.index(i); };
+   auto put = [&out](long int i, T x) { out.index(i) = x; };
+   if(exclusive) {
+      scan(0, n, get, put, op, init, true);
+   } else {
+      const T x0 = A.index(0);
+      out.index(0) = x0;
+      scan(1, n, get, put, op, x0, false);
+   }
+}
+
+
+}  // namespace internal
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// A is allowed to be empty
+// element i of the result is op(A[0], ..., A[i])
+template <OneDimRealBaseType Base, typename Op>
+   requires ScanOperation<Base, Op>
+STRICT_NODISCARD Array1D<RealTypeOf<Base>> inclusive_scan(const Base& A, Op op) {
+   Array1D<RealTypeOf<Base>> R(A.size());
+   internal::scan_into(A, R, op, ValueTypeOf<Base>{}, false);
+   return R;
+}
+
+
+// A is allowed to be empty
+// element i of the result is op(init, A[0], ..., A[i - 1])
+template <OneDimRealBaseType Base, typename Op>
+   requires ScanOperation<Base, Op>
+STRICT_NODISCARD Array1D<RealTypeOf<Base>> exclusive_scan(const Base& A, ValueTypeOf<Base> init, Op op) {
+   Array1D<RealTypeOf<Base>> R(A.size());
+   internal::scan_into(A, R, op, init, true);
+   return R;
+}
+
+
+// A is allowed to be empty
+template <typename Base, typename Op>
+   requires(InPlaceScanType<Base> && ScanOperation<RemoveRef<Base>, Op>)
+void inclusive_scan_inplace(Base&& A, Op op) {
+   internal::scan_into(A, A, op, ValueTypeOf<RemoveRef<Base>>{}, false);
+}
+
+
+// A is allowed to be empty
+template <typename Base, typename Op>
+   requires(InPlaceScanType<Base> && ScanOperation<RemoveRef<Base>, Op>)
+void exclusive_scan_inplace(Base&& A, ValueTypeOf<RemoveRef<Base>> init, Op op) {
+   internal::scan_into(A, A, op, init, true);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// A is allowed to be empty
+template <OneDimRealBaseType Base>
+STRICT_NODISCARD Array1D<RealTypeOf<Base>> cumsum(const Base& A) {
+   return inclusive_scan(A, BinaryPlus{});
+}
+
+
+// A is allowed to be empty
+template <OneDimRealBaseType Base>
+STRICT_NODISCARD Array1D<RealTypeOf<Base>> cumprod(const Base& A) {
+   return inclusive_scan(A, BinaryMult{});
+}
+
+
+// A is allowed to be empty
+template <OneDimRealBaseType Base>
+STRICT_NODISCARD Array1D<RealTypeOf<Base>> cummin(const Base& A) {
+   return inclusive_scan(A, BinaryMin{});
+}
+
+
+// A is allowed to be empty
+template <OneDimRealBaseType Base>
+STRICT_NODISCARD Array1D<RealTypeOf<Base>> cummax(const Base& A) {
+   return inclusive_scan(A, BinaryMax{});
+}
+
+
+// A is allowed to be empty
+template <typename Base>
+   requires InPlaceScanType<Base>
+void cumsum_inplace(Base&& A) {
+   inclusive_scan_inplace(A, BinaryPlus{});
+}
+
+
+// A is allowed to be empty
+template <typename Base>
+   requires InPlaceScanType<Base>
+void cumprod_inplace(Base&& A) {
+   inclusive_scan_inplace(A, BinaryMult{});
+}
+
+
+// A is allowed to be empty
+template <typename Base>
+   requires InPlaceScanType<Base>
+void cummin_inplace(Base&& A) {
+   inclusive_scan_inplace(A, BinaryMin{});
+}
+
+
+// A is allowed to be empty
+template <typename Base>
+   requires InPlaceScanType<Base>
+void cummax_inplace(Base&& A) {
+   inclusive_scan_inplace(A, BinaryMax{});
+}
+
+
+}  // namespace slib
@@ -0,0 +1,38 @@
+//  Copyright (C) 2024 Arkadijs Slobodkins - All Rights Reserved
+// License is 3-clause BSD:
+// https://github.com/arkslobodkins/strict-lib
+
+
+#pragma once
+
+
+#include <string>  // string
+
+#include "derived1D.hpp"
+
+
+namespace slib {
+
+
+#ifdef STRICT_SHARED_MEMORY
+
+
+// name must be of the form /somename, see shm_open(3)
+// elements are zero-initialized
+template <Builtin T>
+STRICT_NODISCARD auto shared_create(const std::string& name, ImplicitInt n) {
+   return SharedArray1D<T, ReadWrite>{internal::SharedCreate{}, name, n};
+}
+
+
+// attaches array created by shared_create in this or another process, without copying
+template <Builtin T, SharedAccessFlag SAF = ReadOnly>
+STRICT_NODISCARD auto shared_attach(const std::string& name) {
+   return SharedArray1D<T, SAF>{internal::SharedAttach{}, name};
+}
+
+
+#endif
+
+
+}  // namespace slib
@@ -0,0 +1,379 @@
+//  Copyright (C) 2024 Arkadijs Slobodkins - All Rights Reserved
+// License is 3-clause BSD:
+// https://github.com/arkslobodkins/strict-lib
+
+
+#pragma once
+
+
+#if __has_include(<sys/mman.h>)
+#define STRICT_SHARED_MEMORY
+#include <fcntl.h>     // O_CREAT, O_EXCL, O_RDWR, O_RDONLY
+#include <sys/mman.h>  // shm_open, shm_unlink, mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // ftruncate, close
+#endif
+
+#include <cerrno>            // errno
+#include <cstdint>           // uint64_t
+#include <cstring>           // memcmp, memcpy, strerror
+#include <initializer_list>  // initializer_list
+#include <string>            // string
+#include <type_traits>       // conditional_t
+#include <utility>           // exchange, move, swap
+
+#include "Common/common.hpp"
+
+
+// Arrays stored in POSIX shared memory. An array is created by one process and attached
+// by name in other processes without copying. Unmapping happens in the destructor, while
+// the shared memory object itself exists until shared_unlink is called, so that lifetime
+// of the data is independent of lifetimes of the processes that use it.
+namespace slib {
+
+
+enum SharedAccessFlag { ReadWrite, ReadOnly };
+
+
+template <Builtin T, SharedAccessFlag SAF>
+class SharedArrayBase1D;
+
+
+template <typename D> concept SharedArray1DType
+    = OneDimBaseType<D>
+   && (DerivedFrom<D, SharedArrayBase1D<BuiltinTypeOf<D>, ReadWrite>>
+       || DerivedFrom<D, SharedArrayBase1D<BuiltinTypeOf<D>, ReadOnly>>);
+
+
+// shared arrays are only available on POSIX systems
+#ifdef STRICT_SHARED_MEMORY
+
+
+namespace internal {
+
+
+struct SharedCreate {};
+struct SharedAttach {};
+struct NonConstShared {};
+
+
+// element type and size are stored in front of the data so that attaching can validate them;
+// the header occupies 512 bytes to keep the data aligned in the same way as Array1D
+struct SharedHeader {
+   char magic[8];
+   std::uint64_t n;
+   std::uint64_t elem_size;
+   unsigned char type;
+};
+
+
+static constexpr inline char shared_magic[8] = {'S', 'L', 'I', 'B', 'S', 'H', 'M', '1'};
+static constexpr inline std::size_t shared_data_offset = 512;
+
+
+STRICT_INLINE std::string shared_error(const std::string& what, const std::string& name) {
+   return what + " failed for shared memory object " + name + ": " + std::strerror(errno) + "\n";
+}
+
+
+}  // namespace internal
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// read-only arrays have constant semantics, which is expressed in the same way as for constant slices
+template <Builtin T, SharedAccessFlag SAF>
+class STRICT_NODISCARD SharedArrayBase1D
+    : private ReferenceBase1D,
+      private std::conditional_t<SAF == ReadOnly, ConstSliceBase, internal::NonConstShared> {
+public:
+   using value_type = Strict<T>;
+   using builtin_type = T;
+
+   // constructors
+   STRICT_NODISCARD explicit SharedArrayBase1D();
+   STRICT_NODISCARD explicit SharedArrayBase1D(internal::SharedCreate, const std::string& name, ImplicitInt n)
+      requires(SAF == ReadWrite);
+   STRICT_NODISCARD explicit SharedArrayBase1D(internal::SharedAttach, const std::string& name);
+
+   // copying would either share or duplicate the mapping, both of which are error-prone
+   SharedArrayBase1D(const SharedArrayBase1D& A) = delete;
+   STRICT_NODISCARD SharedArrayBase1D(SharedArrayBase1D&& A) noexcept;
+
+   // assignments
+   SharedArrayBase1D& operator=(value_type x)
+      requires(SAF == ReadWrite);
+   SharedArrayBase1D& operator=(std::initializer_list<value_type> list)
+      requires(SAF == ReadWrite);
+   SharedArrayBase1D& operator=(const SharedArrayBase1D& A) = delete;
+   SharedArrayBase1D& operator=(SharedArrayBase1D&& A) noexcept;
+   SharedArrayBase1D& operator=(OneDimBaseType auto const& A)
+      requires(SAF == ReadWrite);
+
+   ~SharedArrayBase1D();
+
+   void swap(SharedArrayBase1D& A) noexcept;
+
+   STRICT_NODISCARD_INLINE index_t size() const;
+
+   STRICT_NODISCARD_INLINE value_type& index(ImplicitInt i)
+      requires(SAF == ReadWrite);
+   STRICT_NODISCARD_INLINE const value_type& index(ImplicitInt i) const;
+
+   STRICT_NODISCARD value_type* data()
+      requires(SAF == ReadWrite);
+   STRICT_NODISCARD const value_type* data() const;
+
+   STRICT_NODISCARD builtin_type* blas_data()
+      requires(SAF == ReadWrite);
+   STRICT_NODISCARD const builtin_type* blas_data() const;
+
+   STRICT_NODISCARD const std::string& name() const;
+
+private:
+   void* map_;
+   std::size_t map_bytes_;
+   value_type* data_;
+   index_t n_;
+   std::string name_;
+
+   STRICT_NODISCARD static std::size_t mapping_bytes(index_t n);
+};
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <Builtin T, SharedAccessFlag SAF>
+STRICT_NODISCARD SharedArrayBase1D<T, SAF>::SharedArrayBase1D() : map_{nullptr},
+                                                                  map_bytes_{0},
+                                                                  data_{nullptr},
+                                                                  n_{} {
+}
+
+
+// fails if shared memory object with the same name already exists
+template <Builtin T, SharedAccessFlag SAF>
+STRICT_NODISCARD SharedArrayBase1D<T, SAF>::SharedArrayBase1D(internal::SharedCreate, const std::string& name,
+                                                              ImplicitInt n)
+   requires(SAF == ReadWrite)
+    : SharedArrayBase1D() {
+   ASSERT_STRICT_DEBUG(n.get() > -1_sl);
+   auto bytes = mapping_bytes(n.get());
+
+   int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+   ASSERT_STRICT_ALWAYS_MSG(fd != -1, internal::shared_error("shm_open", name));
+
+   if(ftruncate(fd, static_cast<off_t>(bytes)) == -1) {
+      auto msg = internal::shared_error("ftruncate", name);
+      close(fd);
+      shm_unlink(name.c_str());
+      ASSERT_STRICT_ALWAYS_MSG(false, msg);
+   }
+
+   void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   auto msg = internal::shared_error("mmap", name);
+   close(fd);
+   if(p == MAP_FAILED) {
+      shm_unlink(name.c_str());
+      ASSERT_STRICT_ALWAYS_MSG(false, msg);
+   }
+
+   internal::SharedHeader h{};
+   std::memcpy(h.magic, internal::shared_magic, sizeof(h.magic));
+   h.n = static_cast<std::uint64_t>(n.get().val());
+   h.elem_size = sizeof(T);
+   h.type = internal::type_code<T>();
+   std::memcpy(p, &h, sizeof(h));
+
+   map_ = p;
+   map_bytes_ = bytes;
+   data_ = reinterpret_cast<value_type*>(static_cast<char*>(p) + internal::shared_data_offset);
+   n_ = n.get();
+   name_ = name;
+}
+
+
+template <Builtin T, SharedAccessFlag SAF>
+STRICT_NODISCARD SharedArrayBase1D<T, SAF>::SharedArrayBase1D(internal::SharedAttach, const std::string& name)
+    : SharedArrayBase1D() {
+   int fd = shm_open(name.c_str(), SAF == ReadWrite ? O_RDWR : O_RDONLY, 0);
+   ASSERT_STRICT_ALWAYS_MSG(fd != -1, internal::shared_error("shm_open", name));
+
+   struct stat st{};
+   if(fstat(fd, &st) == -1) {
+      auto msg = internal::shared_error("fstat", name);
+      close(fd);
+      ASSERT_STRICT_ALWAYS_MSG(false, msg);
+   }
+
+   auto bytes = static_cast<std::size_t>(st.st_size);
+   if(bytes < internal::shared_data_offset) {
+      close(fd);
+      ASSERT_STRICT_ALWAYS_MSG(false, "shared memory object " + name + " is not a shared array\n");
+   }
+
+   int prot = SAF == ReadWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+   void* p = mmap(nullptr, bytes, prot, MAP_SHARED, fd, 0);
+   auto msg = internal::shared_error("mmap", name);
+   close(fd);
+   ASSERT_STRICT_ALWAYS_MSG(p != MAP_FAILED, msg);
+
+   // owns the mapping from here on, so that it is released if validation fails
+   map_ = p;
+   map_bytes_ = bytes;
+
+   internal::SharedHeader h;
+   std::memcpy(&h, p, sizeof(h));
+   ASSERT_STRICT_ALWAYS_MSG(std::memcmp(h.magic, internal::shared_magic, sizeof(h.magic)) == 0,
+                            "shared memory object " + name + " is not a shared array\n");
+   ASSERT_STRICT_ALWAYS_MSG(h.elem_size == sizeof(T) && h.type == internal::type_code<T>(),
+                            "shared array " + name + " has a different element type\n");
+   ASSERT_STRICT_ALWAYS_MSG(bytes >= mapping_bytes(index_t{static_cast<long int>(h.n)}),
+                            "shared array " + name + " is truncated\n");
+
+   data_ = reinterpret_cast<value_type*>(static_cast<char*>(p) + internal::shared_data_offset);
+   n_ = index_t{static_cast<long int>(h.n)};
+   name_ = name;
+}
+
+
+template <Builtin T, SharedAccessFlag SAF>
+STRICT_NODISCARD SharedArrayBase1D<T, SAF>::SharedArrayBase1D(SharedArrayBase1D<T, SAF>&& A) noexcept
+    : map_{std::exchange(A.map_, nullptr)},
+      map_bytes_{std::exchange(A.map_bytes_, 0)},
+      data_{std::exchange(A.data_, nullptr)},
+      n_{std::exchange(A.n_, 0_sl)},
+      name_{std::move(A.name_)} {
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <Builtin T, SharedAccessFlag SAF>
+SharedArrayBase1D<T, SAF>& SharedArrayBase1D<T, SAF>::operator=(Strict<T> x)
+   requires(SAF == ReadWrite)
+{
+   internal::fill(x, *this);
+   return *this;
+}
+
+
+template <Builtin T, SharedAccessFlag SAF>
+SharedArrayBase1D<T, SAF>& SharedArrayBase1D<T, SAF>::operator=(std::initializer_list<Strict<T>> list)
+   requires(SAF == ReadWrite)
+{
+   ASSERT_STRICT_DEBUG(this->size() == from_size_t<long int>(list.size()));
+   internal::copy(list, *this);
+   return *this;
+}
+
+
+template <Builtin T, SharedAccessFlag SAF>
+SharedArrayBase1D<T, SAF>& SharedArrayBase1D<T, SAF>::operator=(SharedArrayBase1D<T, SAF>&& A) noexcept {
+   if(this != &A) {
+      // previous mapping is released by tmp
+      SharedArrayBase1D<T, SAF> tmp{std::move(A)};
+      this->swap(tmp);
+   }
+   return *this;
+}
+
+
+template <Builtin T, SharedAccessFlag SAF>
+SharedArrayBase1D<T, SAF>& SharedArrayBase1D<T, SAF>::operator=(OneDimBaseType auto const& A)
+   requires(SAF == ReadWrite)
+{
+   ASSERT_STRICT_DEBUG(same_size(*this, A));
+   internal::copy(A, *this);
+   return *this;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <Builtin T, SharedAccessFlag SAF>
+SharedArrayBase1D<T, SAF>::~SharedArrayBase1D() {
+   if(map_ != nullptr) {
+      munmap(map_, map_bytes_);
+   }
+}
+
+
+template <Builtin T, SharedAccessFlag SAF>
+void SharedArrayBase1D<T, SAF>::swap(SharedArrayBase1D& A) noexcept {
+   std::swap(map_, A.map_);
+   std::swap(map_bytes_, A.map_bytes_);
+   std::swap(data_, A.data_);
+   std::swap(n_, A.n_);
+   std::swap(name_, A.name_);
+}
+
+
+template <Builtin T, SharedAccessFlag SAF>
+STRICT_NODISCARD_INLINE index_t SharedArrayBase1D<T, SAF>::size() const {
+   return n_;
+}
+
+
+template <Builtin T, SharedAccessFlag SAF>
+STRICT_NODISCARD_INLINE Strict<T>& SharedArrayBase1D<T, SAF>::index(ImplicitInt i)
+   requires(SAF == ReadWrite)
+{
+   return data_[i.get().val()];
+}
+
+
+template <Builtin T, SharedAccessFlag SAF>
+STRICT_NODISCARD_INLINE const Strict<T>& SharedArrayBase1D<T, SAF>::index(ImplicitInt i) const {
+   return data_[i.get().val()];
+}
+
+
+template <Builtin T, SharedAccessFlag SAF>
+STRICT_NODISCARD auto SharedArrayBase1D<T, SAF>::data() -> value_type*
+   requires(SAF == ReadWrite)
+{
+   return this->size() != 0_sl ? data_ : nullptr;
+}
+
+
+template <Builtin T, SharedAccessFlag SAF>
+STRICT_NODISCARD auto SharedArrayBase1D<T, SAF>::data() const -> const value_type* {
+   return this->size() != 0_sl ? data_ : nullptr;
+}
+
+
+template <Builtin T, SharedAccessFlag SAF>
+STRICT_NODISCARD auto SharedArrayBase1D<T, SAF>::blas_data() -> builtin_type*
+   requires(SAF == ReadWrite)
+{
+   return reinterpret_cast<T*>(this->size() != 0_sl ? data_ : nullptr);
+}
+
+
+template <Builtin T, SharedAccessFlag SAF>
+STRICT_NODISCARD auto SharedArrayBase1D<T, SAF>::blas_data() const -> const builtin_type* {
+   return reinterpret_cast<const T*>(this->size() != 0_sl ? data_ : nullptr);
+}
+
+
+template <Builtin T, SharedAccessFlag SAF>
+STRICT_NODISCARD const std::string& SharedArrayBase1D<T, SAF>::name() const {
+   return name_;
+}
+
+
+template <Builtin T, SharedAccessFlag SAF>
+STRICT_NODISCARD std::size_t SharedArrayBase1D<T, SAF>::mapping_bytes(index_t n) {
+   return internal::shared_data_offset + to_size_t(n) * sizeof(T);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// removes the name of shared memory object; the memory is released
+// once all processes that attached the array have unmapped it
+STRICT_INLINE void shared_unlink(const std::string& name) {
+   ASSERT_STRICT_ALWAYS_MSG(shm_unlink(name.c_str()) != -1, internal::shared_error("shm_unlink", name));
+}
+
+
+#endif
+
+
+}  // namespace slib
@@ -10,7 +10,14 @@
 #include "Expr/array_expr1D.hpp"
 #include "Util/util.hpp"
 #include "array_IO.hpp"
+#include "array_compress.hpp"
 #include "array_ops.hpp"
 #include "attach1D.hpp"
+#include "bitmask1D.hpp"
 #include "derived1D.hpp"
+#include "interop.hpp"
 #include "math.hpp"
+#include "rolling.hpp"
+#include "sampling.hpp"
+#include "scan.hpp"
+#include "shared1D.hpp"
@@ -0,0 +1,77 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <strict_lib.hpp>
+
+
+using namespace slib;
+
+
+// argsort_increasing and argsort_decreasing compare values below radix_threshold and sort keys
+// above it; both must keep the order of indexes of equal values, including -0 and +0
+bool test_signed_zeros(long int n) {
+   Array1D<double> A(n);
+   for(long int i = 0; i < n; ++i) {
+      A.index(i) = Strict{i % 2 == 0 ? -0. : 0.};
+   }
+   bool ok = true;
+   for(const auto& indexes : {argsort_increasing(A), argsort_decreasing(A)}) {
+      for(long int i = 0; i < n; ++i) {
+         if(indexes[static_cast<std::size_t>(i)].get().val() != i) {
+            std::cout << "signed zeros(n = " << n << "): index " << i << " is "
+                      << indexes[static_cast<std::size_t>(i)].get().val() << "\n";
+            ok = false;
+            break;
+         }
+      }
+   }
+   return ok;
+}
+
+
+// NaNs are placed last in increasing order and first in decreasing order, keeping their order
+bool test_nans(long int n) {
+   const double nan = std::numeric_limits<double>::quiet_NaN();
+   Array1D<double> A(n);
+   std::vector<long int> nans, values;
+   for(long int i = 0; i < n; ++i) {
+      const bool is_nan = i % 3 == 1;
+      A.index(i) = Strict{is_nan ? (i % 2 == 0 ? -nan : nan) : static_cast<double>(i % 5)};
+      (is_nan ? nans : values).push_back(i);
+   }
+   const auto inc = argsort_increasing(A);
+   const auto dec = argsort_decreasing(A);
+   const auto nv = static_cast<long int>(values.size());
+   for(std::size_t k = 0; k < nans.size(); ++k) {
+      if(inc[static_cast<std::size_t>(nv) + k].get().val() != nans[k] || dec[k].get().val() != nans[k]) {
+         std::cout << "NaNs(n = " << n << "): wrong position of NaN " << k << "\n";
+         return false;
+      }
+   }
+   for(long int i = 1; i < nv; ++i) {
+      const auto a = static_cast<std::size_t>(i - 1), b = static_cast<std::size_t>(i);
+      const double x = A.index(inc[a]).val(), y = A.index(inc[b]).val();
+      const double u = A.index(dec[nans.size() + a]).val(), v = A.index(dec[nans.size() + b]).val();
+      if(x > y || (x == y && inc[a].get().val() > inc[b].get().val()) || u < v
+         || (u == v && dec[nans.size() + a].get().val() > dec[nans.size() + b].get().val())) {
+         std::cout << "NaNs(n = " << n << "): values are not sorted at " << i << "\n";
+         return false;
+      }
+   }
+   return true;
+}
+
+
+int main() {
+   bool ok = true;
+   for(long int n : {8L, 1000L, 2000L, 100000L}) {
+      ok = test_signed_zeros(n) && ok;
+      ok = test_nans(n) && ok;
+   }
+
+   std::cout << (ok ? "argsort tests passed\n" : "argsort tests failed\n");
+   return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,70 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <strict_lib.hpp>
+
+
+using namespace slib;
+
+
+// every element of a stream must enter the sample with probability k / n
+bool check_frequencies(const std::string& name, const std::vector<long int>& hits, long int trials, double p,
+                       double tol) {
+   for(std::size_t i = 0; i < hits.size(); ++i) {
+      const double f = static_cast<double>(hits[i]) / static_cast<double>(trials);
+      if(f < p - tol || f > p + tol) {
+         std::cout << name << ": element " << i << " sampled with frequency " << f << ", expected " << p << "\n";
+         return false;
+      }
+   }
+   return true;
+}
+
+
+bool test_reservoir(long int n, long int k, long int trials) {
+   std::vector<long int> hits(static_cast<std::size_t>(n));
+   for(long int t = 0; t < trials; ++t) {
+      Reservoir<long int> r{k, static_cast<std::uint64_t>(t)};
+      for(long int i = 0; i < n; ++i) {
+         r.push(Strict{i});
+      }
+      for(auto x : r.values()) {
+         ++hits[static_cast<std::size_t>(x.val())];
+      }
+   }
+   return check_frequencies("Reservoir(n = " + std::to_string(n) + ", k = " + std::to_string(k) + ")", hits,
+                            trials, static_cast<double>(k) / static_cast<double>(n), 0.05);
+}
+
+
+// positions at the start of every chunk of reservoir_sample are tested when n spans several chunks
+bool test_reservoir_sample(long int n, long int k, long int trials, double tol) {
+   std::vector<long int> hits(static_cast<std::size_t>(n));
+   auto A = sequence(n, 0_sl, 1_sl);
+   for(long int t = 0; t < trials; ++t) {
+      auto S = reservoir_sample(A, k, static_cast<std::uint64_t>(t));
+      if(S.size().val() != std::min(n, k)) {
+         std::cout << "reservoir_sample: wrong size\n";
+         return false;
+      }
+      for(auto x : S) {
+         ++hits[static_cast<std::size_t>(x.val())];
+      }
+   }
+   return check_frequencies("reservoir_sample(n = " + std::to_string(n) + ", k = " + std::to_string(k) + ")",
+                            hits, trials, static_cast<double>(std::min(n, k)) / static_cast<double>(n), tol);
+}
+
+
+int main() {
+   bool ok = test_reservoir(2, 1, 20000);
+   ok = test_reservoir(10, 3, 20000) && ok;
+   ok = test_reservoir(100, 10, 20000) && ok;
+   ok = test_reservoir_sample(10, 3, 20000, 0.05) && ok;
+   ok = test_reservoir_sample(5, 8, 100, 0.) && ok;
+   ok = test_reservoir_sample(2 * 65536 + 100, 60000, 200, 0.2) && ok;
+
+   std::cout << (ok ? "sampling tests passed\n" : "sampling tests failed\n");
+   return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
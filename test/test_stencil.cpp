@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <strict_lib.hpp>
+
+
+using namespace slib;
+
+
+// compares elements of a stencil read by index and by assignment with expected values
+template <typename Expr>
+bool check_values(const std::string& name, const Expr& E, const std::vector<double>& expected) {
+   const Array1D<double> R = E;
+   if(E.size().val() != static_cast<long int>(expected.size()) || R.size() != E.size()) {
+      std::cout << name << ": size " << E.size() << ", expected " << expected.size() << "\n";
+      return false;
+   }
+   for(long int i = 0; i < R.size().val(); ++i) {
+      const double e = expected[static_cast<std::size_t>(i)];
+      if(E.index(i).val() != e || R.index(i).val() != e) {
+         std::cout << name << ": element " << i << " is " << R.index(i) << ", expected " << e << "\n";
+         return false;
+      }
+   }
+   return true;
+}
+
+
+// Truncate keeps the stencils centered at A[c] for c = max(-lo, 0), ..., n - 1 - max(hi, 0)
+template <std::size_t N>
+bool test_truncate(const Array1D<double>& A, const long int (&offsets)[N]) {
+   const long int n = A.size().val();
+   const long int lo = *std::min_element(offsets, offsets + N);
+   const long int hi = *std::max_element(offsets, offsets + N);
+
+   double coeffs[N];
+   Strict<double> c[N];
+   std::string name = "stencil({";
+   for(std::size_t k = 0; k < N; ++k) {
+      coeffs[k] = static_cast<double>(k + 1);
+      c[k] = Strict{coeffs[k]};
+      name += std::to_string(offsets[k]) + (k + 1 < N ? ", " : "})");
+   }
+
+   std::vector<double> expected;
+   for(long int i = std::max(-lo, 0L); i < n - std::max(hi, 0L); ++i) {
+      double s = 0.;
+      for(std::size_t k = 0; k < N; ++k) {
+         s += coeffs[k] * A.index(i + offsets[k]).val();
+      }
+      expected.push_back(s);
+   }
+
+   if constexpr(N == 1) {
+      return check_values(name, stencil(A, {c[0]}, {offsets[0]}), expected);
+   } else if constexpr(N == 2) {
+      return check_values(name, stencil(A, {c[0], c[1]}, {offsets[0], offsets[1]}), expected);
+   } else {
+      return check_values(name, stencil(A, {c[0], c[1], c[2]}, {offsets[0], offsets[1], offsets[2]}), expected);
+   }
+}
+
+
+// Periodic and ConstantPad stencils read the interior directly and select wrapped or padded taps
+// near the boundaries, both through index() and when assigned
+bool test_boundaries(const Array1D<double>& A) {
+   const long int n = A.size().val();
+   auto wrap = [&A, n](long int j) { return A.index((j % n + n) % n).val(); };
+   auto pad = [&A, n](long int j) { return j >= 0 && j < n ? A.index(j).val() : -1.; };
+
+   bool ok = true;
+   for(long int k : {1L, 3L, -2L, -4L}) {
+      std::vector<double> periodic, padded;
+      for(long int i = 0; i < n; ++i) {
+         periodic.push_back(wrap(i - k));
+         padded.push_back(pad(i - k));
+      }
+      const std::string s = std::to_string(k);
+      ok = check_values("shift<Periodic>(A, " + s + ")", shift<Periodic>(A, k), periodic) && ok;
+      ok = check_values("shift(A, " + s + ", -1)", shift(A, k, -1._sd), padded) && ok;
+   }
+
+   std::vector<double> laplacian, padded;
+   for(long int i = 0; i < n; ++i) {
+      laplacian.push_back(wrap(i - 1) - 2. * wrap(i) + wrap(i + 1));
+      padded.push_back(2. * pad(i - 2) + pad(i + 3));
+   }
+   ok = check_values("periodic Laplacian", stencil<Periodic>(A, {1._sd, -2._sd, 1._sd}, {-1, 0, 1}), laplacian)
+     && ok;
+   ok = check_values("stencil<ConstantPad>({-2, 3})", stencil<ConstantPad>(A, {2._sd, 1._sd}, {-2, 3}, -1._sd), padded)
+     && ok;
+   return ok;
+}
+
+
+int main() {
+   const Array1D<double> A{1._sd, 2._sd, 4._sd, 8._sd};
+   bool ok = check_values("stencil({2, 3})", stencil(A, {1._sd, 1._sd}, {2, 3}), {12.});
+   ok = check_values("stencil({2})", stencil(A, {1._sd}, {2}), {4., 8.}) && ok;
+   ok = check_values("stencil({-3, -2})", stencil(A, {1._sd, 1._sd}, {-3, -2}), {3.}) && ok;
+   ok = check_values("stencil({-1, 1})", stencil(A, {-1._sd, 1._sd}, {-1, 1}), {3., 6.}) && ok;
+   ok = check_values("stencil({4})", stencil(A, {1._sd}, {4}), {}) && ok;
+   ok = check_values("diff(A)", diff(A), {1., 2., 4.}) && ok;
+   ok = check_values("diff<2>(A)", diff<2>(A), {1., 2.}) && ok;
+
+   Array1D<double> B(100);
+   for(long int i = 0; i < B.size().val(); ++i) {
+      B.index(i) = Strict{static_cast<double>(i * i % 17)};
+   }
+   ok = test_truncate(B, {0}) && ok;
+   ok = test_truncate(B, {5}) && ok;
+   ok = test_truncate(B, {-7}) && ok;
+   ok = test_truncate(B, {3, 9}) && ok;
+   ok = test_truncate(B, {-9, -3}) && ok;
+   ok = test_truncate(B, {-2, 0, 5}) && ok;
+   ok = test_truncate(B, {4, 1, 2}) && ok;
+   ok = test_truncate(B, {99}) && ok;
+   ok = test_truncate(B, {-99, -50}) && ok;
+   ok = test_truncate(B, {-60, 60}) && ok;
+   ok = test_boundaries(A) && ok;
+   ok = test_boundaries(B) && ok;
+
+   std::cout << (ok ? "stencil tests passed\n" : "stencil tests failed\n");
+   return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}